@@ -2,68 +2,147 @@
 // reserved. Use of this source code is governed by a BSD-style license that
 // can be found in the LICENSE file.
 
+#include <string.h>
+
 #include <iostream>
+#include <map>
+
 #include "examples/shared/app_factory.h"
 
-#include "include/wrapper/cef_message_router.h"
+#include "examples/message_router/message_channel.h"
+#include "examples/message_router/message_registry.h"
+#include "examples/message_router/query_router_renderer.h"
 
 namespace message_router {
 namespace {
 
 const char kTestMessageName[] = "MessageRouterTest";
 
-class MyV8Handler : public CefV8Handler {
+class MyV8Handler;
+
+// Member function that implements a native function. |id| identifies the
+// function.
+typedef bool (MyV8Handler::*NativeMethod)(MessageId id,
+                                          const CefV8ValueList& arguments,
+                                          CefRefPtr<CefV8Value>& retval);
+
+// Implements the native functions that are exposed to JavaScript.
+class MyV8Handler : public CefBaseRefCounted {
  public:
-  MyV8Handler() {}
-
-  void SendProcessMessage(std::string message) {
-    CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create(message);
-    std::cout << "Render SendProcessMessage: " << message << std::endl;
-    // CefRefPtr<CefListValue> args = msg->GetArgumentList();
-    // args->SetString(0, "string_arg");
-    browser->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+  MyV8Handler() {
+    // Native functions are found by ID when they are exposed.
+    functions_.Register("cefVersion", &MyV8Handler::GetVersion);
+    functions_.Register("roomOpen", &MyV8Handler::SendToBrowser);
+    functions_.Register("roomClosed", &MyV8Handler::SendToBrowser);
+    functions_.Register("testFunction", &MyV8Handler::SendToBrowser);
   }
 
-  virtual bool Execute(const CefString& name,
-                       CefRefPtr<CefV8Value> object,
-                       const CefV8ValueList& arguments,
-                       CefRefPtr<CefV8Value>& retval,
-                       CefString& exception) override {
-    std::cout << "Render Execute: " << name.ToString() << std::endl;
-    if (name == "cefVersion") {
-      retval = CefV8Value::CreateString("CEF v0.1.0");
-      return true;
-    } else if (name == "roomOpen") {
-      std::cout << "Render:roomOpen - Render Value!" << std::endl;
-      retval = CefV8Value::CreateString("roomOpen called");
-      SendProcessMessage(name);
-
-      return true;
-    } else if (name == "roomClosed") {
-      std::cout << "Render:roomClosed - Render Value!" << std::endl;
-      retval = CefV8Value::CreateString("roomClosed called");
-      SendProcessMessage(name);
-      return true;
-    } else if (name == "testFunction") {
-      std::cout << "Render:testFunction!" << std::endl;
-      retval = CefV8Value::CreateString("Render testFunction!");
-      SendProcessMessage(name);
-      return true;
-    }
+  // Returns a new function object for the native function |name|, or nullptr
+  // if no such function is registered.
+  CefRefPtr<CefV8Value> CreateFunction(const std::string& name);
+
+  // Discard the messages queued for |browser|. Call when the browser is
+  // destroyed.
+  void CloseChannel(CefRefPtr<CefBrowser> browser) {
+    ChannelMap::iterator it = channels_.find(browser->GetIdentifier());
+    if (it == channels_.end())
+      return;
+    it->second->Close();
+    channels_.erase(it);
+  }
 
-    // Function does not exist.
-    return false;
+ private:
+  // Map of browser ID to the channel for messages sent by that browser.
+  typedef std::map<int, CefRefPtr<MessageChannel>> ChannelMap;
+
+  // Returns the channel for |browser|, creating it if necessary. Messages to
+  // the browser process are sent at the end of the current task so that calls
+  // made by the same script share one IPC.
+  CefRefPtr<MessageChannel> GetChannel(CefRefPtr<CefBrowser> browser) {
+    CefRefPtr<MessageChannel>& channel = channels_[browser->GetIdentifier()];
+    if (!channel)
+      channel = new MessageChannel(browser, PID_BROWSER, TID_RENDERER, 0);
+    return channel;
+  }
+
+  bool GetVersion(MessageId id,
+                  const CefV8ValueList& arguments,
+                  CefRefPtr<CefV8Value>& retval) {
+    retval = CefV8Value::CreateString("CEF v0.1.0");
+    return true;
   }
 
-  CefRefPtr<CefBrowser> browser;
+  // Send message |id| to the browser process on behalf of the browser that
+  // owns the calling context. The first argument, if it is a string, is sent
+  // as the message payload. Messages are batched by the browser's channel and
+  // large payloads such as JSON documents are sent via shared memory.
+  bool SendToBrowser(MessageId id,
+                     const CefV8ValueList& arguments,
+                     CefRefPtr<CefV8Value>& retval) {
+    CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
+    CefRefPtr<CefBrowser> browser = context ? context->GetBrowser() : nullptr;
+    if (!browser)
+      return false;
+
+    std::string payload;
+    if (!arguments.empty() && arguments[0]->IsString())
+      payload = arguments[0]->GetStringValue();
+    const std::string& name = functions_.GetName(id);
+    std::cout << "Render SendProcessMessage: " << name << " ("
+              << payload.size() << " bytes)" << std::endl;
+    GetChannel(browser)->Send(id, payload);
+    retval = CefV8Value::CreateString(name + " called");
+    return true;
+  }
+
+  MessageRegistry<NativeMethod> functions_;
+  ChannelMap channels_;
+
   // Provide the reference counting implementation for this class.
   IMPLEMENT_REFCOUNTING(MyV8Handler);
 };
 
+// V8 handler for a single native function. The implementation is resolved
+// when the function is created, so calls are dispatched without comparing
+// names.
+class NativeFunction : public CefV8Handler {
+ public:
+  NativeFunction(CefRefPtr<MyV8Handler> owner,
+                 MessageId id,
+                 NativeMethod method)
+      : owner_(owner), id_(id), method_(method) {}
+
+  bool Execute(const CefString& name,
+               CefRefPtr<CefV8Value> object,
+               const CefV8ValueList& arguments,
+               CefRefPtr<CefV8Value>& retval,
+               CefString& exception) override {
+    return ((*owner_).*method_)(id_, arguments, retval);
+  }
+
+ private:
+  const CefRefPtr<MyV8Handler> owner_;
+  const MessageId id_;
+  const NativeMethod method_;
+
+  IMPLEMENT_REFCOUNTING(NativeFunction);
+};
+
+CefRefPtr<CefV8Value> MyV8Handler::CreateFunction(const std::string& name) {
+  const MessageId id = GetMessageId(name);
+  const NativeMethod* method = functions_.Find(id);
+  if (!method)
+    return nullptr;
+  return CefV8Value::CreateFunction(name,
+                                    new NativeFunction(this, id, *method));
+}
+
 // Implementation of CefApp for the renderer process.
 class RendererApp : public CefApp, public CefRenderProcessHandler {
  public:
-  RendererApp() {}
+  RendererApp() {
+    messages_.Register("exposeFunction", &RendererApp::OnExposeFunction);
+  }
 
   // CefApp methods:
   CefRefPtr<CefRenderProcessHandler> GetRenderProcessHandler() override {
@@ -72,13 +151,11 @@ class RendererApp : public CefApp, public CefRenderProcessHandler {
 
   // CefRenderProcessHandler methods:
   void OnWebKitInitialized() override {
-    // Create the renderer-side router for query handling.
-    // For now just use the default cefQuery. We are not using that
-    // functionality at the moment
-    CefMessageRouterConfig config;
-    config.js_query_function = "queryUpstage";
-    config.js_cancel_function = "cancelQuery";
-    message_router_ = CefMessageRouterRendererSide::Create(config);
+    // Create the renderer-side router for query handling. One router serves
+    // both namespaces.
+    query_router_ = new QueryRouterRendererSide();
+    query_router_->AddNamespace("cefQuery", "cefQueryCancel");
+    query_router_->AddNamespace("queryUpstage", "cancelQuery");
     handler_ = new MyV8Handler();
     // message_handler_.reset(new MessageHandler("startup_url_ "));
   }
@@ -86,14 +163,12 @@ class RendererApp : public CefApp, public CefRenderProcessHandler {
   void OnContextCreated(CefRefPtr<CefBrowser> browser,
                         CefRefPtr<CefFrame> frame,
                         CefRefPtr<CefV8Context> context) override {
-    message_router_->OnContextCreated(browser, frame, context);
+    query_router_->OnContextCreated(browser, frame, context);
     // Register function handlers with the 'window' object.
 
     CefRefPtr<CefV8Value> window = context->GetGlobal();
-    handler_->browser = browser;
     // Create the query function.
-    CefRefPtr<CefV8Value> func =
-        CefV8Value::CreateFunction("cefVersion", handler_);
+    CefRefPtr<CefV8Value> func = handler_->CreateFunction("cefVersion");
     window->SetValue("cefVersion", func, V8_PROPERTY_ATTRIBUTE_NONE);
     std::cout << "Render - Added function to window:  "
               << func->GetFunctionName() << std::endl;
@@ -142,7 +217,12 @@ class RendererApp : public CefApp, public CefRenderProcessHandler {
   void OnContextReleased(CefRefPtr<CefBrowser> browser,
                          CefRefPtr<CefFrame> frame,
                          CefRefPtr<CefV8Context> context) override {
-    message_router_->OnContextReleased(browser, frame, context);
+    query_router_->OnContextReleased(browser, frame, context);
+  }
+
+  void OnBrowserDestroyed(CefRefPtr<CefBrowser> browser) override {
+    if (handler_)
+      handler_->CloseChannel(browser);
   }
 
   bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
@@ -153,8 +233,9 @@ class RendererApp : public CefApp, public CefRenderProcessHandler {
 
     std::cout << "Render OnProcessMessageReceived: "
               << message->GetName().ToString() << std::endl;
+    // Messages sent via shared memory have no argument list.
     CefRefPtr<CefListValue> args = message->GetArgumentList();
-    int size = args->GetSize();
+    int size = args ? args->GetSize() : 0;
     std::cout << "args size: " << size << std::endl;
 
     for (int i = 0; i < size; i++) {
@@ -167,38 +248,22 @@ class RendererApp : public CefApp, public CefRenderProcessHandler {
       }
     }
 
-    std::string name = message->GetName().ToString();
-    if (name == "exposeFunction") {
-      std::string fn_name = args->GetString(0).ToString();
-      std::cout << "Render exposeFunction: " << fn_name << std::endl;
-      CefRefPtr<CefV8Context> context = browser->GetMainFrame()->GetV8Context();
-      context->Enter();
-
-      CefRefPtr<CefV8Value> window = context->GetGlobal();
-
-      CefRefPtr<CefV8Value> new_fn =
-          CefV8Value::CreateFunction(fn_name, handler_);
-      window->SetValue(fn_name, new_fn, V8_PROPERTY_ATTRIBUTE_NONE);
-      std::cout << "Added function to window: " << new_fn->GetFunctionName()
-                << std::endl;
-
-      // Test calling the function
-      CefRefPtr<CefV8Value> function = window->GetValue("showAlert");
-
-      if (function.get() && function->IsFunction()) {
-        CefV8ValueList args;
-        CefRefPtr<CefV8Value> retval = function->ExecuteFunction(nullptr, args);
-        std::cout << "Function return value null?: " << retval->IsNull()
-                  << std::endl;
-        // Handle the return value or exceptions if needed
-      } else {
-        std::cout << "Function does not exist!" << std::endl;
+    MessageBatchReader reader(message);
+    if (reader.IsValid()) {
+      // Dispatch each message of the batch in order.
+      MessageId id;
+      const char* data;
+      size_t data_size;
+      while (reader.Next(id, data, data_size)) {
+        const MessageMethod* method = messages_.Find(id);
+        if (method)
+          (this->*(*method))(browser, data, data_size);
+        else
+          LOG(WARNING) << "Unknown message ID " << id;
       }
-
-      context->Exit();
       handled = true;
     } else {
-      handled = message_router_->OnProcessMessageReceived(
+      handled = query_router_->OnProcessMessageReceived(
           browser, frame, source_process, message);
     }
 
@@ -213,11 +278,63 @@ class RendererApp : public CefApp, public CefRenderProcessHandler {
   }
 
  private:
+  // Handler for a message sent by the browser process with the |size| bytes
+  // at |data| as payload.
+  typedef void (RendererApp::*MessageMethod)(CefRefPtr<CefBrowser> browser,
+                                             const char* data,
+                                             size_t size);
+
+  // Expose the native function named by the payload to JavaScript. The name
+  // may be followed by a NUL separator and JavaScript code for the function.
+  void OnExposeFunction(CefRefPtr<CefBrowser> browser,
+                        const char* data,
+                        size_t size) {
+    const char* separator = static_cast<const char*>(memchr(data, '\0', size));
+    const size_t name_size = separator ? separator - data : size;
+    const std::string fn_name(data, name_size);
+    const std::string code =
+        separator ? std::string(separator + 1, size - name_size - 1)
+                  : std::string();
+    std::cout << "Render exposeFunction: " << fn_name << " code: " << code
+              << std::endl;
+    CefRefPtr<CefV8Value> new_fn = handler_->CreateFunction(fn_name);
+    if (!new_fn) {
+      LOG(WARNING) << "Unknown native function " << fn_name;
+      return;
+    }
+
+    CefRefPtr<CefV8Context> context = browser->GetMainFrame()->GetV8Context();
+    context->Enter();
+
+    CefRefPtr<CefV8Value> window = context->GetGlobal();
+    window->SetValue(fn_name, new_fn, V8_PROPERTY_ATTRIBUTE_NONE);
+    std::cout << "Added function to window: " << new_fn->GetFunctionName()
+              << std::endl;
+
+    // Test calling the function
+    CefRefPtr<CefV8Value> function = window->GetValue("showAlert");
+
+    if (function.get() && function->IsFunction()) {
+      CefV8ValueList args;
+      CefRefPtr<CefV8Value> retval = function->ExecuteFunction(nullptr, args);
+      std::cout << "Function return value null?: " << retval->IsNull()
+                << std::endl;
+      // Handle the return value or exceptions if needed
+    } else {
+      std::cout << "Function does not exist!" << std::endl;
+    }
+
+    context->Exit();
+  }
+
   // Handles the renderer side of query routing.
-  CefRefPtr<CefMessageRouterRendererSide> message_router_;
+  CefRefPtr<QueryRouterRendererSide> query_router_;
   CefRefPtr<MyV8Handler> handler_;
   // std::unique_ptr<CefMessageRouterBrowserSide::Handler> message_handler_;
 
+  // Handlers for messages sent by the browser process.
+  MessageRegistry<MessageMethod> messages_;
+
   IMPLEMENT_REFCOUNTING(RendererApp);
   DISALLOW_COPY_AND_ASSIGN(RendererApp);
 };
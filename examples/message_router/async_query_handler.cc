@@ -0,0 +1,163 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/message_router/async_query_handler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+#include "examples/shared/worker_pool.h"
+
+namespace message_router {
+
+namespace {
+
+const char kBusyErrorMessage[] = "Too many queries are pending";
+
+int64_t NowMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+const int AsyncQueryHandler::kQueryBusyError = -3;
+
+// State of a query that is queued or running. The canceled flag is set on the
+// UI thread and read on the worker thread.
+class AsyncQueryHandler::PendingQuery : public CefBaseRefCounted {
+ public:
+  PendingQuery(int64_t query_id,
+               const std::string& request,
+               CefRefPtr<Callback> callback)
+      : query_id(query_id),
+        request(request),
+        callback(callback),
+        queued_time_us(NowMicroseconds()),
+        canceled(false) {}
+
+  const int64_t query_id;
+  const std::string request;
+  const CefRefPtr<Callback> callback;
+  const int64_t queued_time_us;
+  std::atomic<bool> canceled;
+
+ private:
+  IMPLEMENT_REFCOUNTING(PendingQuery);
+  DISALLOW_COPY_AND_ASSIGN(PendingQuery);
+};
+
+AsyncQueryHandler::AsyncQueryHandler(size_t max_queue_depth)
+    : max_queue_depth_(max_queue_depth), stats_() {
+  DCHECK_GT(max_queue_depth_, 0U);
+}
+
+AsyncQueryHandler::~AsyncQueryHandler() {
+  DCHECK(pending_.empty());
+}
+
+AsyncQueryHandler::Stats AsyncQueryHandler::GetStats() const {
+  base::AutoLock lock_scope(lock_);
+  return stats_;
+}
+
+bool AsyncQueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
+                                CefRefPtr<CefFrame> frame,
+                                int64_t query_id,
+                                const std::string& request,
+                                bool persistent,
+                                CefRefPtr<Callback> callback) {
+  CEF_REQUIRE_UI_THREAD();
+  if (!AcceptQuery(browser, frame, request, persistent))
+    return false;
+
+  bool queued = false;
+  {
+    base::AutoLock lock_scope(lock_);
+    if (stats_.queue_depth < max_queue_depth_) {
+      stats_.queue_depth++;
+      stats_.max_queue_depth =
+          std::max(stats_.max_queue_depth, stats_.queue_depth);
+      queued = true;
+    } else {
+      stats_.rejected++;
+    }
+  }
+
+  if (!queued) {
+    callback->Failure(kQueryBusyError, kBusyErrorMessage);
+    return true;
+  }
+
+  CefRefPtr<PendingQuery> query =
+      new PendingQuery(query_id, request, callback);
+  pending_[query_id] = query;
+
+  // Handlers are expected to outlive the worker pool.
+  if (!shared::WorkerPool::PostTask(base::BindOnce(
+          &AsyncQueryHandler::RunQuery, base::Unretained(this), query))) {
+    RunQuery(query);
+  }
+  return true;
+}
+
+void AsyncQueryHandler::OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                                        CefRefPtr<CefFrame> frame,
+                                        int64_t query_id) {
+  CEF_REQUIRE_UI_THREAD();
+  PendingMap::iterator it = pending_.find(query_id);
+  if (it != pending_.end())
+    it->second->canceled = true;
+}
+
+void AsyncQueryHandler::RunQuery(CefRefPtr<PendingQuery> query) {
+  const int64_t wait_us = NowMicroseconds() - query->queued_time_us;
+
+  bool executed = false;
+  if (!query->canceled) {
+    std::string response;
+    int error_code = 0;
+    const bool success = ExecuteQuery(query->request, response, error_code);
+    executed = true;
+
+    // The callback must not be used once the query has been canceled. Any
+    // response that races with cancellation is discarded by the router.
+    if (!query->canceled) {
+      if (success)
+        query->callback->Success(response);
+      else
+        query->callback->Failure(error_code, response);
+    }
+  }
+
+  {
+    base::AutoLock lock_scope(lock_);
+    stats_.queue_depth--;
+    if (executed) {
+      stats_.executed++;
+      stats_.total_wait_us += wait_us;
+      stats_.max_wait_us = std::max(stats_.max_wait_us, wait_us);
+    }
+  }
+
+  if (CefCurrentlyOn(TID_UI)) {
+    OnQueryDone(query->query_id);
+  } else {
+    CefPostTask(TID_UI, base::BindOnce(&AsyncQueryHandler::OnQueryDone,
+                                       base::Unretained(this),
+                                       query->query_id));
+  }
+}
+
+void AsyncQueryHandler::OnQueryDone(int64_t query_id) {
+  CEF_REQUIRE_UI_THREAD();
+  pending_.erase(query_id);
+}
+
+}  // namespace message_router
@@ -0,0 +1,104 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_ASYNC_QUERY_HANDLER_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_ASYNC_QUERY_HANDLER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+
+#include "include/base/cef_lock.h"
+
+#include "examples/message_router/query_router_browser.h"
+
+namespace message_router {
+
+// Base class for query handlers that execute queries on the shared::WorkerPool
+// instead of the browser process UI thread, so that slow queries do not block
+// window management and IPC for other browsers. The response is sent from the
+// worker thread via the query callback, which posts it to the UI thread. At
+// most |max_queue_depth| queries may be queued or running at the same time;
+// further queries fail with kQueryBusyError. If the pool does not exist the
+// query is executed on the UI thread.
+class AsyncQueryHandler : public QueryRouterBrowserSide::Handler {
+ public:
+  // Error code sent when the queue is full.
+  static const int kQueryBusyError;
+
+  struct Stats {
+    // Number of queries that are queued or running.
+    size_t queue_depth;
+    // Largest |queue_depth| seen.
+    size_t max_queue_depth;
+    // Number of queries executed.
+    uint64_t executed;
+    // Number of queries rejected because the queue was full.
+    uint64_t rejected;
+    // Total and largest time that executed queries spent waiting for a worker
+    // thread, in microseconds.
+    int64_t total_wait_us;
+    int64_t max_wait_us;
+  };
+
+  explicit AsyncQueryHandler(size_t max_queue_depth);
+  ~AsyncQueryHandler() override;
+
+  // Returns the current counters. May be called on any thread.
+  Stats GetStats() const;
+
+  // QueryRouterBrowserSide::Handler methods.
+  bool OnQuery(CefRefPtr<CefBrowser> browser,
+               CefRefPtr<CefFrame> frame,
+               int64_t query_id,
+               const std::string& request,
+               bool persistent,
+               CefRefPtr<Callback> callback) override;
+  void OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                       CefRefPtr<CefFrame> frame,
+                       int64_t query_id) override;
+
+ protected:
+  // Called on the UI thread. Return true to handle the query, or false to
+  // offer it to the next handler.
+  virtual bool AcceptQuery(CefRefPtr<CefBrowser> browser,
+                           CefRefPtr<CefFrame> frame,
+                           const std::string& request,
+                           bool persistent) = 0;
+
+  // Called on a worker thread to execute an accepted query. Set |response|
+  // and return true on success. On failure set |error_code|, set |response|
+  // to the error message and return false.
+  virtual bool ExecuteQuery(const std::string& request,
+                            std::string& response,
+                            int& error_code) = 0;
+
+ private:
+  class PendingQuery;
+
+  // Map of query ID to queued or running query. Only accessed on the UI
+  // thread.
+  typedef std::map<int64_t, CefRefPtr<PendingQuery>> PendingMap;
+
+  // Called on a worker thread, or on the UI thread if there is no pool.
+  void RunQuery(CefRefPtr<PendingQuery> query);
+
+  // Called on the UI thread when a query has finished running.
+  void OnQueryDone(int64_t query_id);
+
+  const size_t max_queue_depth_;
+
+  PendingMap pending_;
+
+  mutable base::Lock lock_;
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncQueryHandler);
+};
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_ASYNC_QUERY_HANDLER_H_
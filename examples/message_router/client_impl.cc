@@ -6,9 +6,15 @@
 
 #include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <string>
 
 #include "include/wrapper/cef_helpers.h"
 
+#include "examples/message_router/async_query_handler.h"
+#include "examples/message_router/message_channel.h"
+#include "examples/message_router/query_stream.h"
+#include "examples/shared/client_manager.h"
 #include "examples/shared/client_util.h"
 #include "examples/shared/resource_util.h"
 
@@ -18,40 +24,77 @@ namespace {
 
 const char kTestMessageName[] = "MessageRouterTest";
 
+// Request that returns the queue statistics of the cefQuery handler.
+const char kStatsRequest[] = "debug_stats";
+
+// Persistent request that streams telemetry samples.
+const char kTelemetryRequest[] = "telemetry";
+
+const MessageId kExposeFunctionId = GetMessageId("exposeFunction");
+
+// Returns the payload of an "exposeFunction" message for the native function
+// |name|. |code|, if any, follows the name after a NUL separator.
+std::string MakeExposeFunctionPayload(const std::string& name,
+                                      const std::string& code) {
+  std::string payload = name;
+  if (!code.empty()) {
+    payload.push_back('\0');
+    payload.append(code);
+  }
+  return payload;
+}
+
+// Maximum number of queries per handler that may be queued or running on the
+// worker pool.
+const size_t kMaxQueueDepth = 64;
+
 // Handle messages in the browser process.
-class MessageHandler : public CefMessageRouterBrowserSide::Handler {
+class MessageHandler : public AsyncQueryHandler {
  public:
   explicit MessageHandler(const CefString& startup_url)
-      : startup_url_(startup_url) {}
+      : AsyncQueryHandler(kMaxQueueDepth), startup_url_(startup_url) {}
 
+ protected:
   // Called due to cefQuery execution in message_router.html.
-  bool OnQuery(CefRefPtr<CefBrowser> browser,
-               CefRefPtr<CefFrame> frame,
-               int64_t query_id,
-               const CefString& request,
-               bool persistent,
-               CefRefPtr<Callback> callback) override {
-    // Only handle messages from the startup URL.
-
-    std::cout << "MessageHandler - Browser OnQuery: " << request.ToString()
-              << std::endl;
+  bool AcceptQuery(CefRefPtr<CefBrowser> browser,
+                   CefRefPtr<CefFrame> frame,
+                   const std::string& request,
+                   bool persistent) override {
+    std::cout << "MessageHandler - Browser OnQuery: " << request << std::endl;
 
+    // Only handle messages from the startup URL.
     const std::string& url = frame->GetURL();
     if (url.find(startup_url_) != 0)
       return false;
 
-    const std::string& message_name = request;
-    if (message_name.find(kTestMessageName) == 0) {
-      // if (true) {
-      // Reverse the string and return.
-      std::string result = message_name.substr(sizeof(kTestMessageName));
-      std::reverse(result.begin(), result.end());
-      std::cout << "Browser OnQuery result: " << result << std::endl;
-      callback->Success(result);
+    return request.find(kTestMessageName) == 0 || request == kStatsRequest;
+  }
+
+  bool ExecuteQuery(const std::string& request,
+                    std::string& response,
+                    int& error_code) override {
+    if (request == kStatsRequest) {
+      const Stats stats = GetStats();
+      std::stringstream ss;
+      ss << "queue_depth=" << stats.queue_depth
+         << " max_queue_depth=" << stats.max_queue_depth
+         << " executed=" << stats.executed << " rejected=" << stats.rejected
+         << " max_wait_us=" << stats.max_wait_us;
+      if (stats.executed > 0) {
+        ss << " avg_wait_us="
+           << stats.total_wait_us / static_cast<int64_t>(stats.executed);
+      }
+      response = ss.str();
       return true;
     }
 
-    return false;
+    // Reverse the string and return. The separator after the message name is
+    // optional.
+    response =
+        request.substr(std::min(request.size(), sizeof(kTestMessageName)));
+    std::reverse(response.begin(), response.end());
+    std::cout << "Browser OnQuery result: " << response << std::endl;
+    return true;
   }
 
  private:
@@ -60,50 +103,126 @@ class MessageHandler : public CefMessageRouterBrowserSide::Handler {
   DISALLOW_COPY_AND_ASSIGN(MessageHandler);
 };
 
-class MyHandler : public CefMessageRouterBrowserSide::Handler {
+class MyHandler : public AsyncQueryHandler {
  public:
   explicit MyHandler(const CefString& startup_url)
-      : startup_url_(startup_url) {}
+      : AsyncQueryHandler(kMaxQueueDepth), startup_url_(startup_url) {}
+
+ protected:
+  // Called due to queryUpstage execution in message_router.html.
+  bool AcceptQuery(CefRefPtr<CefBrowser> browser,
+                   CefRefPtr<CefFrame> frame,
+                   const std::string& request,
+                   bool persistent) override {
+    std::cout << "MyHandler Browser OnQuery: " << request << std::endl;
 
-  // Called due to cefQuery execution in message_router.html.
-  bool OnQuery(CefRefPtr<CefBrowser> browser,
-               CefRefPtr<CefFrame> frame,
-               int64_t query_id,
-               const CefString& request,
-               bool persistent,
-               CefRefPtr<Callback> callback) override {
     // Only handle messages from the startup URL.
+    const std::string& url = frame->GetURL();
+    return url.find(startup_url_) == 0;
+  }
 
-    std::cout << "MyHandler Browser OnQuery: " << request.ToString()
-              << std::endl;
+  bool ExecuteQuery(const std::string& request,
+                    std::string& response,
+                    int& error_code) override {
+    response = "result";
+    return true;
+  }
 
-    const std::string& url = frame->GetURL();
-    if (url.find(startup_url_) != 0)
-      return false;
+ private:
+  const CefString startup_url_;
 
-    const std::string& message_name = request;
-    // if (message_name.find(kTestMessageName) == 0) {
-    if (true) {
-      // Reverse the string and return.
+  DISALLOW_COPY_AND_ASSIGN(MyHandler);
+};
 
-      callback->Success("result");
-      return true;
+// Number of samples sent by a telemetry feed before it ends.
+const int kTelemetrySamples = 10000;
+
+// Writes telemetry samples to a stream as fast as the page consumes them.
+class TelemetryFeed : public CefBaseRefCounted {
+ public:
+  explicit TelemetryFeed(CefRefPtr<QueryStream> stream)
+      : stream_(stream), sequence_(0) {}
+
+  void Start() {
+    // The stream releases the callback, and with it this object, when it is
+    // closed.
+    stream_->SetWritableCallback(base::BindRepeating(
+        &TelemetryFeed::Pump, CefRefPtr<TelemetryFeed>(this)));
+  }
+
+ private:
+  // Called on the UI thread when credits arrive.
+  void Pump() {
+    while (sequence_ < kTelemetrySamples &&
+           stream_->Write("sample " + std::to_string(sequence_))) {
+      sequence_++;
     }
+    if (sequence_ == kTelemetrySamples)
+      stream_->End();
+  }
+
+  const CefRefPtr<QueryStream> stream_;
+  int sequence_;
+
+  IMPLEMENT_REFCOUNTING(TelemetryFeed);
+  DISALLOW_COPY_AND_ASSIGN(TelemetryFeed);
+};
+
+// Streams telemetry samples in response to persistent "telemetry" queries.
+class TelemetryHandler : public StreamQueryHandler {
+ public:
+  explicit TelemetryHandler(const CefString& startup_url)
+      : startup_url_(startup_url) {}
 
+ protected:
+  // Called due to queryUpstage execution in message_router.html.
+  bool OnStreamQuery(CefRefPtr<CefBrowser> browser,
+                     CefRefPtr<CefFrame> frame,
+                     const std::string& request,
+                     CefRefPtr<QueryStream> stream) override {
+    // Only handle messages from the startup URL.
+    const std::string& url = frame->GetURL();
+    if (url.find(startup_url_) != 0 || request != kTelemetryRequest)
+      return false;
+
+    CefRefPtr<TelemetryFeed> feed = new TelemetryFeed(stream);
+    feed->Start();
     return true;
   }
 
  private:
   const CefString startup_url_;
 
-  DISALLOW_COPY_AND_ASSIGN(MyHandler);
+  DISALLOW_COPY_AND_ASSIGN(TelemetryHandler);
 };
 
+// Returns the query router shared by all Client instances. The router serves
+// both the "cefQuery" and "queryUpstage" namespaces. The router and its
+// handlers are created on first use and intentionally leaked.
+CefRefPtr<QueryRouterBrowserSide> GetQueryRouter(const CefString& startup_url) {
+  CEF_REQUIRE_UI_THREAD();
+  static QueryRouterBrowserSide* router = nullptr;
+  if (!router) {
+    router = new QueryRouterBrowserSide();
+    router->AddRef();
+    router->AddHandler("cefQuery", new MessageHandler(startup_url), false);
+    router->AddHandler("queryUpstage", new MyHandler(startup_url), false);
+    router->AddHandler("queryUpstage", new TelemetryHandler(startup_url),
+                       true);
+  }
+  return router;
+}
+
 }  // namespace
 
 Client::Client(const CefString& startup_url)
-    : startup_url_(startup_url), browser_ct_(0) {
+    : startup_url_(startup_url), query_router_(GetQueryRouter(startup_url)) {
   my_load_handler_ = new MyCustomLoadHandler();
+
+  // Messages sent by native functions in the render process.
+  messages_.Register("roomOpen", &Client::OnRoomOpen);
+  messages_.Register("roomClosed", &Client::OnRoomClosed);
+  messages_.Register("testFunction", &Client::OnTestFunction);
 }
 
 void Client::OnTitleChange(CefRefPtr<CefBrowser> browser,
@@ -112,63 +231,42 @@ void Client::OnTitleChange(CefRefPtr<CefBrowser> browser,
   shared::OnTitleChange(browser, title);
 }
 
-bool Client::HandleMessage(CefRefPtr<CefBrowser> browser,
-                           CefRefPtr<CefProcessMessage> message) {
-  std::cout << "Browser Client HandleMessage: " << message->GetName().ToString()
-            << std::endl;
+void Client::OnRoomOpen(CefRefPtr<CefBrowser> browser,
+                        const char* data,
+                        size_t size) {
+  std::cout << "Handled roomOpen (" << size << " bytes)" << std::endl;
 
-  if (message->GetName() == "roomOpen") {
-    std::cout << "Handled roomOpen" << std::endl;
-    CEF_REQUIRE_UI_THREAD();
-
-    // Create the message object.
-    CefRefPtr<CefProcessMessage> msg =
-        CefProcessMessage::Create("exposeFunction");
-    // Retrieve the argument list object.
-    CefRefPtr<CefListValue> args = msg->GetArgumentList();
-    // Populate the argument values.
-    args->SetString(0, "testFunction");
-    args->SetString(1, "JS CODE");
-    // Send the process message to the main frame in the render process.
-    // Use PID_BROWSER instead when sending a message to the browser process.
-    CefRefPtr<CefFrame> frame = browser->GetMainFrame();
-    frame->SendProcessMessage(PID_RENDERER, msg);
+  // Ask the render process to expose the function. The message is batched
+  // with any other messages sent during this task.
+  GetChannel(browser)->Send(
+      kExposeFunctionId, MakeExposeFunctionPayload("testFunction", "JS CODE"));
+}
 
-    return true;
-  } else if (message->GetName() == "roomClosed") {
-    std::cout << "Handled roomClosed" << std::endl;
-    return true;
-  } else if (message->GetName() == "testFunction") {
-    std::cout << "Handled testFunction" << std::endl;
-    return true;
-  }
+void Client::OnRoomClosed(CefRefPtr<CefBrowser> browser,
+                          const char* data,
+                          size_t size) {
+  std::cout << "Handled roomClosed (" << size << " bytes)" << std::endl;
+}
 
-  // CefRefPtr<CefListValue> args = message->GetArgumentList();
-
-  // int size = args->GetSize();
-  // for (int i = 0; i < size; i++) {
-  //   CefValueType type = args->GetType(i);
-  //   switch (type) {
-  //     case VTYPE_BOOL:
-  //       std::cout << "VTYPE_BOOL: " << args->GetBool(i) << std::endl;
-  //       break;
-  //     case VTYPE_DOUBLE:
-  //       std::cout << "VTYPE_DOUBLE: " << args->GetDouble(i) << std::endl;
-  //       break;
-  //     case VTYPE_INT:
-  //       std::cout << "VTYPE_INT: " << args->GetInt(i) << std::endl;
-  //       break;
-  //     case VTYPE_STRING:
-  //       std::cout << "VTYPE_STRING: " << args->GetString(i).ToString()
-  //                 << std::endl;
-  //       break;
-  //     default:
-  //       std::cout << "VTYPE_UNKNOWN: " << std::endl;
-  //       break;
-  //   }
-  // }
+void Client::OnTestFunction(CefRefPtr<CefBrowser> browser,
+                            const char* data,
+                            size_t size) {
+  std::cout << "Handled testFunction (" << size << " bytes)" << std::endl;
+}
 
-  return false;
+void Client::DispatchBatch(CefRefPtr<CefBrowser> browser,
+                           CefRefPtr<CefProcessMessage> message) {
+  MessageBatchReader reader(message);
+  MessageId id;
+  const char* data;
+  size_t size;
+  while (reader.Next(id, data, size)) {
+    const MessageMethod* method = messages_.Find(id);
+    if (method)
+      (this->*(*method))(browser, data, size);
+    else
+      LOG(WARNING) << "Unknown message ID " << id;
+  }
 }
 
 bool Client::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
@@ -180,9 +278,10 @@ bool Client::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
   std::cout << "Browser Client OnProcessMessageReceived: "
             << message->GetName().ToString() << std::endl;
 
+  // Messages sent via shared memory have no argument list.
   CefRefPtr<CefListValue> args = message->GetArgumentList();
 
-  int size = args->GetSize();
+  int size = args ? args->GetSize() : 0;
   for (int i = 0; i < size; i++) {
     CefValueType type = args->GetType(i);
     switch (type) {
@@ -205,12 +304,16 @@ bool Client::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
     }
   }
 
-  bool handled = false;
-  handled = message_router_->OnProcessMessageReceived(browser, frame,
-                                                      source_process, message);
-  handled |= my_router_->OnProcessMessageReceived(browser, frame,
-                                                  source_process, message);
-  handled |= HandleMessage(browser, message);
+  if (message->GetName() == MessageChannel::kBatchMessageName) {
+    // Messages sent by the MessageChannel in the renderer are not offered to
+    // the routers.
+    DispatchBatch(browser, message);
+    return true;
+  }
+
+  // Each query router message is routed to the handlers of its namespace.
+  const bool handled = query_router_->OnProcessMessageReceived(
+      browser, frame, source_process, message);
 
   std::cout << "Browser Client OnProcessMessageReceived handled: " << handled
             << std::endl;
@@ -220,25 +323,6 @@ bool Client::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
 void Client::OnAfterCreated(CefRefPtr<CefBrowser> browser) {
   CEF_REQUIRE_UI_THREAD();
 
-  if (!message_router_) {
-    // Create the browser-side router for query handling.
-    CefMessageRouterConfig config;
-    message_router_ = CefMessageRouterBrowserSide::Create(config);
-    CefMessageRouterConfig my_config;
-    my_config.js_query_function = "queryUpstage";
-    my_config.js_cancel_function = "cancelQuery";
-    my_router_ = CefMessageRouterBrowserSide::Create(my_config);
-
-    // Register handlers with the router.
-    message_handler_.reset(new MessageHandler(startup_url_));
-    message_router_->AddHandler(message_handler_.get(), false);
-
-    my_handler_.reset(new MyHandler(startup_url_));
-    my_router_->AddHandler(my_handler_.get(), false);
-  }
-
-  browser_ct_++;
-
   // Call the default shared implementation.
   shared::OnAfterCreated(browser);
 }
@@ -251,15 +335,22 @@ bool Client::DoClose(CefRefPtr<CefBrowser> browser) {
 void Client::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
   CEF_REQUIRE_UI_THREAD();
 
-  if (--browser_ct_ == 0) {
-    // Free the router when the last browser is closed.
-    message_router_->RemoveHandler(message_handler_.get());
-    message_handler_.reset();
-    message_router_ = nullptr;
+  ChannelMap::iterator it = channels_.find(browser->GetIdentifier());
+  if (it != channels_.end()) {
+    it->second->Close();
+    channels_.erase(it);
   }
 
+  // Cancel pending queries for the browser.
+  query_router_->OnBeforeClose(browser);
+
   // Call the default shared implementation.
   shared::OnBeforeClose(browser);
+
+  // The router is shared by all browsers so only log its cumulative latency
+  // histograms once, when the last browser has closed.
+  if (shared::ClientManager::GetInstance()->GetBrowserCount() == 0)
+    query_router_->LogLatencyHistograms();
 }
 
 bool Client::OnBeforeBrowse(CefRefPtr<CefBrowser> browser,
@@ -269,37 +360,30 @@ bool Client::OnBeforeBrowse(CefRefPtr<CefBrowser> browser,
                             bool is_redirect) {
   CEF_REQUIRE_UI_THREAD();
 
-  // Create the message object.
-  CefRefPtr<CefProcessMessage> msg =
-      CefProcessMessage::Create("exposeFunction");
-
-  // Retrieve the argument list object.
-  CefRefPtr<CefListValue> args = msg->GetArgumentList();
-
-  // Populate the argument values.
-  args->SetString(0, "roomOpen");
-  // args->SetInt(0, 10);
-
-  // Send the process message to the main frame in the render process.
-  // Use PID_BROWSER instead when sending a message to the browser process.
-  //
-  std::cout << "Browser Send Message: " << args->GetString(0).ToString()
-            << std::endl;
-  browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, msg);
-
-  CefRefPtr<CefProcessMessage> msg2 =
-      CefProcessMessage::Create("exposeFunction");
-  CefRefPtr<CefListValue> args2 = msg2->GetArgumentList();
-  args2->SetString(0, "roomClosed");
-  std::cout << "Browser Send Message: " << args2->GetString(0).ToString()
-            << std::endl;
-  browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, msg2);
-
-  message_router_->OnBeforeBrowse(browser, frame);
-  my_router_->OnBeforeBrowse(browser, frame);
+  // Ask the render process to expose the functions. Both messages are sent
+  // to the main frame as a single batch at the end of the current task.
+  CefRefPtr<MessageChannel> channel = GetChannel(browser);
+  std::cout << "Browser Send Message: roomOpen" << std::endl;
+  channel->Send(kExposeFunctionId,
+                MakeExposeFunctionPayload("roomOpen", std::string()));
+  std::cout << "Browser Send Message: roomClosed" << std::endl;
+  channel->Send(kExposeFunctionId,
+                MakeExposeFunctionPayload("roomClosed", std::string()));
+
+  query_router_->OnBeforeBrowse(browser, frame);
   return false;
 }
 
+CefRefPtr<MessageChannel> Client::GetChannel(CefRefPtr<CefBrowser> browser) {
+  CEF_REQUIRE_UI_THREAD();
+  CefRefPtr<MessageChannel>& channel = channels_[browser->GetIdentifier()];
+  if (!channel) {
+    // Messages to the render process are sent at the end of the current task.
+    channel = new MessageChannel(browser, PID_RENDERER, TID_UI, 0);
+  }
+  return channel;
+}
+
 CefRefPtr<CefResourceRequestHandler> Client::GetResourceRequestHandler(
     CefRefPtr<CefBrowser> browser,
     CefRefPtr<CefFrame> frame,
@@ -316,8 +400,7 @@ void Client::OnRenderProcessTerminated(CefRefPtr<CefBrowser> browser,
                                        TerminationStatus status) {
   CEF_REQUIRE_UI_THREAD();
 
-  message_router_->OnRenderProcessTerminated(browser);
-  my_router_->OnRenderProcessTerminated(browser);
+  query_router_->OnRenderProcessTerminated(browser);
 }
 
 CefRefPtr<CefResourceHandler> Client::GetResourceHandler(
@@ -334,7 +417,7 @@ CefRefPtr<CefResourceHandler> Client::GetResourceHandler(
   // example implementation.
   const std::string& resource_path = shared::GetResourcePath(url);
   if (!resource_path.empty())
-    return shared::GetResourceHandler(resource_path);
+    return shared::GetResourceHandler(resource_path, request);
 
   return nullptr;
 }
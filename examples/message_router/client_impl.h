@@ -6,8 +6,12 @@
 #define CEF_EXAMPLES_MESSAGE_ROUTER_CLIENT_IMPL_H_
 
 #include <iostream>
+#include <map>
 #include "include/cef_client.h"
-#include "include/wrapper/cef_message_router.h"
+
+#include "examples/message_router/message_channel.h"
+#include "examples/message_router/message_registry.h"
+#include "examples/message_router/query_router_browser.h"
 
 namespace message_router {
 
@@ -125,20 +129,42 @@ class Client : public CefClient,
       CefRefPtr<CefRequest> request) override;
 
  private:
-  bool HandleMessage(CefRefPtr<CefBrowser> browser,
+  // Handler for a message sent by the render process with the |size| bytes
+  // at |data| as payload.
+  typedef void (Client::*MessageMethod)(CefRefPtr<CefBrowser> browser,
+                                        const char* data,
+                                        size_t size);
+
+  void OnRoomOpen(CefRefPtr<CefBrowser> browser, const char* data, size_t size);
+  void OnRoomClosed(CefRefPtr<CefBrowser> browser,
+                    const char* data,
+                    size_t size);
+  void OnTestFunction(CefRefPtr<CefBrowser> browser,
+                      const char* data,
+                      size_t size);
+
+  // Dispatch the messages of a batch sent by the render process.
+  void DispatchBatch(CefRefPtr<CefBrowser> browser,
                      CefRefPtr<CefProcessMessage> message);
 
+  // Returns the channel for sending messages to the render process of
+  // |browser|, creating it if necessary. The channel is closed in
+  // OnBeforeClose.
+  CefRefPtr<MessageChannel> GetChannel(CefRefPtr<CefBrowser> browser);
+
  private:
-  // Handles the browser side of query routing.
-  CefRefPtr<CefMessageRouterBrowserSide> message_router_;
-  std::unique_ptr<CefMessageRouterBrowserSide::Handler> message_handler_;
-  CefRefPtr<CefMessageRouterBrowserSide> my_router_;
-  std::unique_ptr<CefMessageRouterBrowserSide::Handler> my_handler_;
   CefRefPtr<MyCustomLoadHandler> my_load_handler_;
   const CefString startup_url_;
 
-  // Track the number of browsers using this Client.
-  int browser_ct_;
+  // Handles the browser side of query routing. Shared by all instances.
+  CefRefPtr<QueryRouterBrowserSide> query_router_;
+
+  // Map of browser ID to message channel.
+  typedef std::map<int, CefRefPtr<MessageChannel>> ChannelMap;
+  ChannelMap channels_;
+
+  // Handlers for messages sent by the render process.
+  MessageRegistry<MessageMethod> messages_;
 
   IMPLEMENT_REFCOUNTING(Client);
   DISALLOW_COPY_AND_ASSIGN(Client);
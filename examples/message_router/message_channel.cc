@@ -0,0 +1,190 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/message_router/message_channel.h"
+
+#include <string.h>
+
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace message_router {
+
+namespace {
+
+// Flush immediately when the encoded batch reaches this size.
+const size_t kMaxBatchSize = 256 * 1024;
+
+// Each record is the message ID and payload size followed by the payload
+// bytes.
+struct RecordHeader {
+  MessageId id;
+  uint32_t payload_size;
+};
+
+char* WriteRecord(char* out, MessageId id, const char* data, size_t size) {
+  RecordHeader header;
+  header.id = id;
+  header.payload_size = static_cast<uint32_t>(size);
+  memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+  if (size > 0)
+    memcpy(out, data, size);
+  return out + size;
+}
+
+size_t GetRecordSize(size_t size) {
+  return sizeof(RecordHeader) + size;
+}
+
+}  // namespace
+
+const char MessageChannel::kBatchMessageName[] = "MessageBatch";
+
+MessageChannel::MessageChannel(CefRefPtr<CefBrowser> browser,
+                               CefProcessId target_process,
+                               CefThreadId thread,
+                               int64_t flush_delay_ms)
+    : browser_(browser),
+      target_process_(target_process),
+      thread_(thread),
+      flush_delay_ms_(flush_delay_ms),
+      flush_pending_(false),
+      closed_(false) {}
+
+MessageChannel::~MessageChannel() {}
+
+void MessageChannel::Send(MessageId id, const std::string& payload) {
+  DCHECK(CefCurrentlyOn(thread_));
+  if (closed_)
+    return;
+
+  if (payload.size() >= kSharedMemoryThreshold) {
+    // Large payloads gain nothing from batching. Write the record directly
+    // into shared memory.
+    Flush();
+    PayloadBuilder builder(kBatchMessageName, GetRecordSize(payload.size()));
+    if (builder.data()) {
+      WriteRecord(builder.data(), id, payload.data(), payload.size());
+      SendBatch(builder.Build());
+    }
+    return;
+  }
+
+  Append(id, payload.data(), payload.size());
+  if (batch_.size() >= kMaxBatchSize)
+    Flush();
+  else
+    ScheduleFlush();
+}
+
+void MessageChannel::SendLatest(MessageId id, const std::string& payload) {
+  DCHECK(CefCurrentlyOn(thread_));
+  if (closed_)
+    return;
+
+  for (size_t i = 0; i < latest_.size(); ++i) {
+    if (latest_[i].first == id) {
+      latest_[i].second = payload;
+      return;
+    }
+  }
+
+  latest_.push_back(std::make_pair(id, payload));
+  ScheduleFlush();
+}
+
+void MessageChannel::Flush() {
+  DCHECK(CefCurrentlyOn(thread_));
+  if (closed_ || (batch_.empty() && latest_.empty()))
+    return;
+
+  size_t size = batch_.size();
+  for (size_t i = 0; i < latest_.size(); ++i)
+    size += GetRecordSize(latest_[i].second.size());
+
+  // Batches that exceed the threshold are written directly into shared
+  // memory.
+  PayloadBuilder builder(kBatchMessageName, size);
+  char* out = builder.data();
+  if (out) {
+    memcpy(out, batch_.data(), batch_.size());
+    out += batch_.size();
+    for (size_t i = 0; i < latest_.size(); ++i) {
+      out = WriteRecord(out, latest_[i].first, latest_[i].second.data(),
+                        latest_[i].second.size());
+    }
+    SendBatch(builder.Build());
+  }
+
+  batch_.clear();
+  latest_.clear();
+}
+
+void MessageChannel::Close() {
+  DCHECK(CefCurrentlyOn(thread_));
+  batch_.clear();
+  latest_.clear();
+  closed_ = true;
+}
+
+void MessageChannel::Append(MessageId id, const char* data, size_t size) {
+  const size_t offset = batch_.size();
+  batch_.resize(offset + GetRecordSize(size));
+  WriteRecord(&batch_[offset], id, data, size);
+}
+
+void MessageChannel::SendBatch(CefRefPtr<CefProcessMessage> message) {
+  CefRefPtr<CefFrame> frame = browser_->GetMainFrame();
+  if (frame && message)
+    frame->SendProcessMessage(target_process_, message);
+}
+
+void MessageChannel::ScheduleFlush() {
+  if (flush_pending_)
+    return;
+  flush_pending_ = true;
+
+  // The task keeps this object alive until it runs.
+  base::OnceClosure task = base::BindOnce(&MessageChannel::OnFlushTask,
+                                          CefRefPtr<MessageChannel>(this));
+  if (flush_delay_ms_ > 0)
+    CefPostDelayedTask(thread_, std::move(task), flush_delay_ms_);
+  else
+    CefPostTask(thread_, std::move(task));
+}
+
+void MessageChannel::OnFlushTask() {
+  flush_pending_ = false;
+  Flush();
+}
+
+MessageBatchReader::MessageBatchReader(CefRefPtr<CefProcessMessage> message)
+    : payload_(message),
+      valid_(payload_.IsValid() &&
+             message->GetName() == MessageChannel::kBatchMessageName),
+      offset_(0) {}
+
+bool MessageBatchReader::Next(MessageId& id,
+                              const char*& data,
+                              size_t& size) {
+  if (!valid_)
+    return false;
+
+  const size_t remaining = payload_.size() - offset_;
+  RecordHeader header;
+  if (remaining < sizeof(header))
+    return false;
+  memcpy(&header, payload_.data() + offset_, sizeof(header));
+  if (remaining - sizeof(header) < header.payload_size)
+    return false;
+
+  id = header.id;
+  data = payload_.data() + offset_ + sizeof(header);
+  size = header.payload_size;
+  offset_ += GetRecordSize(size);
+  return true;
+}
+
+}  // namespace message_router
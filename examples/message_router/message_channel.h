@@ -0,0 +1,114 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_CHANNEL_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_CHANNEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/cef_browser.h"
+#include "include/cef_process_message.h"
+
+#include "examples/message_router/message_registry.h"
+#include "examples/message_router/message_transport.h"
+
+namespace message_router {
+
+// Queues small process messages for the main frame of a browser and sends
+// them to the other process as a single batch message. The batch is sent at
+// the end of the current task, or after |flush_delay_ms| if that is greater
+// than zero, so that bursts of messages cost one IPC. Messages are identified
+// by MessageId. Payloads of at least kSharedMemoryThreshold bytes are sent
+// immediately in a batch of their own after flushing the queue, so that
+// message order is preserved. Must be used on the thread passed to the
+// constructor.
+class MessageChannel : public CefBaseRefCounted {
+ public:
+  // Name of batch messages. Use MessageBatchReader to read them.
+  static const char kBatchMessageName[];
+
+  MessageChannel(CefRefPtr<CefBrowser> browser,
+                 CefProcessId target_process,
+                 CefThreadId thread,
+                 int64_t flush_delay_ms);
+
+  // Queue message |id| with |payload|.
+  void Send(MessageId id, const std::string& payload);
+
+  // Queue message |id| with |payload|, replacing the payload of a message with
+  // the same ID that was queued with this method and has not been sent yet.
+  // Use for state updates where only the latest value matters. Coalesced
+  // messages are delivered after the other messages of the batch.
+  void SendLatest(MessageId id, const std::string& payload);
+
+  // Send the queued messages now.
+  void Flush();
+
+  // Discard the queued messages and stop sending. Call when the browser is
+  // closing.
+  void Close();
+
+ private:
+  typedef std::vector<std::pair<MessageId, std::string>> LatestList;
+
+  ~MessageChannel() override;
+
+  // Append a record to |batch_|.
+  void Append(MessageId id, const char* data, size_t size);
+
+  void SendBatch(CefRefPtr<CefProcessMessage> message);
+
+  // Post a flush task if one is not already pending.
+  void ScheduleFlush();
+
+  void OnFlushTask();
+
+  CefRefPtr<CefBrowser> browser_;
+  const CefProcessId target_process_;
+  const CefThreadId thread_;
+  const int64_t flush_delay_ms_;
+
+  // Encoded records for messages queued with Send. Keeps its capacity across
+  // flushes.
+  std::string batch_;
+
+  // Messages queued with SendLatest, in queue order.
+  LatestList latest_;
+
+  bool flush_pending_;
+  bool closed_;
+
+  IMPLEMENT_REFCOUNTING(MessageChannel);
+  DISALLOW_COPY_AND_ASSIGN(MessageChannel);
+};
+
+// Reads the messages contained in a batch message sent by MessageChannel.
+// Payloads are read in place.
+class MessageBatchReader {
+ public:
+  explicit MessageBatchReader(CefRefPtr<CefProcessMessage> message);
+
+  // Returns false if |message| is not a valid batch message.
+  bool IsValid() const { return valid_; }
+
+  // Read the next message. Returns false when there are no more messages or
+  // the batch is malformed.
+  bool Next(MessageId& id, const char*& data, size_t& size);
+
+ private:
+  MessagePayload payload_;
+  const bool valid_;
+  size_t offset_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageBatchReader);
+};
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_CHANNEL_H_
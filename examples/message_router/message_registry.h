@@ -0,0 +1,89 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_REGISTRY_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+
+#include "include/base/cef_logging.h"
+#include "include/base/cef_macros.h"
+
+namespace message_router {
+
+// Identifies a message name on the wire. Messages sent by MessageChannel
+// carry the ID instead of the name.
+typedef uint32_t MessageId;
+
+// Returns the ID for |name|, which is the 32-bit FNV-1a hash of the name. IDs
+// for string literals are computed at compile time.
+constexpr MessageId GetMessageId(const char* name) {
+  MessageId hash = 2166136261u;
+  for (; *name; ++name) {
+    hash ^= static_cast<unsigned char>(*name);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+inline MessageId GetMessageId(const std::string& name) {
+  return GetMessageId(name.c_str());
+}
+
+// Maps message IDs to handlers of type |Handler|, which should be cheap to
+// copy such as a function or member function pointer. Handlers are registered
+// by name at startup and found with a single hash lookup. Not thread-safe;
+// register all handlers before dispatching.
+template <typename Handler>
+class MessageRegistry {
+ public:
+  MessageRegistry() {}
+
+  // Register |handler| for |name|. Returns false if |name|, or another name
+  // with the same ID, is already registered.
+  bool Register(const std::string& name, Handler handler) {
+    const MessageId id = GetMessageId(name);
+    typename EntryMap::const_iterator it = entries_.find(id);
+    if (it != entries_.end()) {
+      LOG(ERROR) << "Message name " << name << " conflicts with "
+                 << it->second.name;
+      return false;
+    }
+
+    Entry& entry = entries_[id];
+    entry.name = name;
+    entry.handler = handler;
+    return true;
+  }
+
+  // Returns the handler for |id|, or nullptr if |id| is not registered.
+  const Handler* Find(MessageId id) const {
+    typename EntryMap::const_iterator it = entries_.find(id);
+    return it == entries_.end() ? nullptr : &it->second.handler;
+  }
+
+  // Returns the name registered for |id|, or an empty string.
+  const std::string& GetName(MessageId id) const {
+    static const std::string empty;
+    typename EntryMap::const_iterator it = entries_.find(id);
+    return it == entries_.end() ? empty : it->second.name;
+  }
+
+ private:
+  struct Entry {
+    std::string name;
+    Handler handler;
+  };
+  typedef std::unordered_map<MessageId, Entry> EntryMap;
+  EntryMap entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageRegistry);
+};
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_REGISTRY_H_
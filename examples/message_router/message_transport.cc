@@ -0,0 +1,107 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/message_router/message_transport.h"
+
+#include <string.h>
+
+#include "include/cef_values.h"
+
+namespace message_router {
+
+// Matches the default threshold used by CefMessageRouterConfig.
+const size_t kSharedMemoryThreshold = 16000;
+
+PayloadBuilder::PayloadBuilder(const std::string& name, size_t size)
+    : name_(name), size_(size), data_(nullptr) {
+  if (size_ >= kSharedMemoryThreshold) {
+    shared_builder_ = CefSharedProcessMessageBuilder::Create(name_, size_);
+    if (shared_builder_ && shared_builder_->IsValid()) {
+      data_ = static_cast<char*>(shared_builder_->Memory());
+    } else {
+      LOG(ERROR) << "Failed to allocate " << size_
+                 << " bytes of shared memory for " << name_;
+      shared_builder_ = nullptr;
+    }
+  } else {
+    buffer_.resize(size_);
+    data_ = &buffer_[0];
+  }
+}
+
+CefRefPtr<CefProcessMessage> PayloadBuilder::Build() {
+  if (!data_)
+    return nullptr;
+  data_ = nullptr;
+
+  if (shared_builder_) {
+    CefRefPtr<CefProcessMessage> message = shared_builder_->Build();
+    shared_builder_ = nullptr;
+    return message;
+  }
+
+  CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create(name_);
+  if (size_ > 0) {
+    message->GetArgumentList()->SetBinary(
+        0, CefBinaryValue::Create(buffer_.data(), size_));
+  }
+  return message;
+}
+
+CefRefPtr<CefProcessMessage> CreatePayloadMessage(const std::string& name,
+                                                  const void* data,
+                                                  size_t size) {
+  PayloadBuilder builder(name, size);
+  if (!builder.data())
+    return nullptr;
+  if (size > 0)
+    memcpy(builder.data(), data, size);
+  return builder.Build();
+}
+
+void SendPayloadMessage(CefRefPtr<CefFrame> frame,
+                        CefProcessId target_process,
+                        const std::string& name,
+                        const std::string& payload) {
+  CefRefPtr<CefProcessMessage> message =
+      CreatePayloadMessage(name, payload.data(), payload.size());
+  if (message)
+    frame->SendProcessMessage(target_process, message);
+}
+
+MessagePayload::MessagePayload(CefRefPtr<CefProcessMessage> message)
+    : data_(""), size_(0), valid_(false) {
+  region_ = message->GetSharedMemoryRegion();
+  if (region_) {
+    if (region_->IsValid()) {
+      data_ = static_cast<const char*>(region_->Memory());
+      size_ = region_->Size();
+      valid_ = true;
+    } else {
+      region_ = nullptr;
+    }
+    return;
+  }
+
+  CefRefPtr<CefListValue> args = message->GetArgumentList();
+  if (!args)
+    return;
+  if (args->GetSize() == 0) {
+    // Empty payload.
+    valid_ = true;
+    return;
+  }
+  if (args->GetType(0) != VTYPE_BINARY)
+    return;
+
+  CefRefPtr<CefBinaryValue> binary = args->GetBinary(0);
+  copy_.resize(binary->GetSize());
+  if (!copy_.empty())
+    binary->GetData(&copy_[0], copy_.size(), 0);
+  data_ = copy_.data();
+  size_ = copy_.size();
+  valid_ = true;
+}
+
+}  // namespace message_router
@@ -0,0 +1,102 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_TRANSPORT_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_TRANSPORT_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "include/cef_frame.h"
+#include "include/cef_process_message.h"
+#include "include/cef_shared_memory_region.h"
+#include "include/cef_shared_process_message_builder.h"
+
+namespace message_router {
+
+// Payloads of at least this many bytes are sent via shared memory instead of
+// being serialized into the message argument list. Also used as the
+// |message_size_threshold| of the message routers.
+extern const size_t kSharedMemoryThreshold;
+
+// Creates a process message that carries a binary payload. Small payloads are
+// stored as a binary value in the argument list. Payloads of at least
+// kSharedMemoryThreshold bytes are written directly into a shared memory
+// region that is handed to the other process without further copies. Use
+// MessagePayload to read the payload on the receiving side.
+class PayloadBuilder {
+ public:
+  PayloadBuilder(const std::string& name, size_t size);
+
+  // Returns the buffer that receives the payload. The caller must write
+  // size() bytes before calling Build(). Returns nullptr if the shared memory
+  // region could not be allocated.
+  char* data() { return data_; }
+  size_t size() const { return size_; }
+
+  // Returns true if the payload will be sent via shared memory.
+  bool is_shared() const { return !!shared_builder_; }
+
+  // Returns the message. The builder must not be used after this call.
+  CefRefPtr<CefProcessMessage> Build();
+
+ private:
+  const std::string name_;
+  const size_t size_;
+
+  // Used for payloads sent via shared memory.
+  CefRefPtr<CefSharedProcessMessageBuilder> shared_builder_;
+
+  // Used for small payloads.
+  std::string buffer_;
+
+  char* data_;
+
+  DISALLOW_COPY_AND_ASSIGN(PayloadBuilder);
+};
+
+// Returns a message named |name| with a copy of the |size| bytes at |data| as
+// its payload.
+CefRefPtr<CefProcessMessage> CreatePayloadMessage(const std::string& name,
+                                                  const void* data,
+                                                  size_t size);
+
+// Send a message named |name| with |payload| to |target_process| via |frame|.
+void SendPayloadMessage(CefRefPtr<CefFrame> frame,
+                        CefProcessId target_process,
+                        const std::string& name,
+                        const std::string& payload);
+
+// Read access to the payload of a message created by PayloadBuilder. Payloads
+// received via shared memory are read in place.
+class MessagePayload {
+ public:
+  explicit MessagePayload(CefRefPtr<CefProcessMessage> message);
+
+  // Returns false if |message| does not carry a payload.
+  bool IsValid() const { return valid_; }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // Returns true if the payload was received via shared memory.
+  bool is_shared() const { return !!region_; }
+
+  std::string ToString() const { return std::string(data_, size_); }
+
+ private:
+  CefRefPtr<CefSharedMemoryRegion> region_;
+  std::string copy_;
+
+  const char* data_;
+  size_t size_;
+  bool valid_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessagePayload);
+};
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_MESSAGE_TRANSPORT_H_
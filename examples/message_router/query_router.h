@@ -0,0 +1,118 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+
+#include "include/cef_process_message.h"
+
+#include "examples/message_router/message_registry.h"
+#include "examples/message_router/message_transport.h"
+
+// Definitions shared by QueryRouterBrowserSide and QueryRouterRendererSide.
+// A query router serves one or more namespaces, each of which is a pair of
+// JavaScript query and cancel functions such as "cefQuery" and
+// "cefQueryCancel". Namespaces are identified on the wire by the MessageId of
+// the query function name.
+
+namespace message_router {
+
+// Process message names. Payloads start with the matching header structure
+// followed by the message body.
+const char kQueryMessageName[] = "QueryRouter.Query";
+const char kCancelMessageName[] = "QueryRouter.Cancel";
+const char kResponseMessageName[] = "QueryRouter.Response";
+const char kCreditMessageName[] = "QueryRouter.Credit";
+
+// Error codes passed to the JavaScript onFailure callback by the router.
+const int kQueryCanceledError = -1;
+const int kQueryUnhandledError = -2;
+const int kQueryTimeoutError = -5;
+
+// Value of CancelHeader::request_id that cancels all requests of a context.
+const int32_t kAllRequests = -1;
+
+// Number of responses a persistent query may receive before the renderer has
+// consumed any of them, unless the query specifies its own window.
+const int32_t kDefaultCreditWindow = 16;
+
+// Renderer to browser. The body is the request string. |credits| is the
+// initial credit window of a persistent query, or zero for other queries.
+// |timeout_ms| is the time the handler has to respond, or zero for no
+// deadline.
+struct QueryHeader {
+  MessageId namespace_id;
+  int32_t context_id;
+  int32_t request_id;
+  int32_t credits;
+  int32_t timeout_ms;
+  uint8_t persistent;
+};
+
+// Renderer to browser. No body.
+struct CancelHeader {
+  MessageId namespace_id;
+  int32_t context_id;
+  int32_t request_id;
+};
+
+// Renderer to browser. Grants |credits| more responses to a persistent query
+// after the page has consumed previous responses. No body.
+struct CreditHeader {
+  MessageId namespace_id;
+  int32_t context_id;
+  int32_t request_id;
+  int32_t credits;
+};
+
+// Browser to renderer. The body is the response string, or the error message
+// if |success| is zero.
+struct ResponseHeader {
+  int32_t context_id;
+  int32_t request_id;
+  int32_t error_code;
+  uint8_t success;
+};
+
+// Returns a message named |name| whose payload is |header| followed by the
+// |body_size| bytes at |body|. Large bodies are written directly into shared
+// memory.
+template <typename Header>
+CefRefPtr<CefProcessMessage> CreateRouterMessage(const char* name,
+                                                 const Header& header,
+                                                 const char* body,
+                                                 size_t body_size) {
+  PayloadBuilder builder(name, sizeof(header) + body_size);
+  if (!builder.data())
+    return nullptr;
+  memcpy(builder.data(), &header, sizeof(header));
+  if (body_size > 0)
+    memcpy(builder.data() + sizeof(header), body, body_size);
+  return builder.Build();
+}
+
+// Read |header| from the start of |payload| and return the rest of the
+// payload in |body| and |body_size|. Returns false if the payload is
+// malformed.
+template <typename Header>
+bool ReadRouterMessage(const MessagePayload& payload,
+                       Header& header,
+                       const char*& body,
+                       size_t& body_size) {
+  if (!payload.IsValid() || payload.size() < sizeof(header))
+    return false;
+  memcpy(&header, payload.data(), sizeof(header));
+  body = payload.data() + sizeof(header);
+  body_size = payload.size() - sizeof(header);
+  return true;
+}
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_H_
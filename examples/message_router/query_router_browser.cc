@@ -0,0 +1,485 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/message_router/query_router_browser.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace message_router {
+
+namespace {
+
+const char kCanceledErrorMessage[] = "The query has been canceled";
+const char kUnhandledErrorMessage[] = "The query was not handled";
+const char kTimeoutErrorMessage[] = "The query timed out";
+
+// Deadline resolution, and number of timer wheel slots. One revolution of the
+// wheel covers 12.8 seconds.
+const int64_t kTimerTickMs = 50;
+const size_t kTimerSlotCount = 256;
+
+int64_t NowMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t NowMilliseconds() {
+  return NowMicroseconds() / 1000;
+}
+
+}  // namespace
+
+// Forwards responses to the router on the UI thread. Only holds the query ID
+// so responses for queries that have completed or been canceled are ignored.
+class QueryRouterBrowserSide::CallbackImpl
+    : public QueryRouterBrowserSide::Callback {
+ public:
+  CallbackImpl(CefRefPtr<QueryRouterBrowserSide> router, int64_t query_id)
+      : router_(router), query_id_(query_id) {}
+
+  void Success(const std::string& response) override {
+    if (!CefCurrentlyOn(TID_UI)) {
+      CefPostTask(TID_UI, base::BindOnce(&CallbackImpl::Success,
+                                         CefRefPtr<CallbackImpl>(this),
+                                         response));
+      return;
+    }
+    router_->OnCallbackSuccess(query_id_, response);
+  }
+
+  void Failure(int error_code, const std::string& error_message) override {
+    if (!CefCurrentlyOn(TID_UI)) {
+      CefPostTask(TID_UI, base::BindOnce(&CallbackImpl::Failure,
+                                         CefRefPtr<CallbackImpl>(this),
+                                         error_code, error_message));
+      return;
+    }
+    router_->OnCallbackFailure(query_id_, error_code, error_message);
+  }
+
+ private:
+  const CefRefPtr<QueryRouterBrowserSide> router_;
+  const int64_t query_id_;
+
+  IMPLEMENT_REFCOUNTING(CallbackImpl);
+  DISALLOW_COPY_AND_ASSIGN(CallbackImpl);
+};
+
+QueryRouterBrowserSide::LatencyHistogram::LatencyHistogram()
+    : buckets(), count(0), total_us(0), max_us(0), timeouts(0) {}
+
+void QueryRouterBrowserSide::LatencyHistogram::Add(int64_t latency_us) {
+  size_t bucket = 0;
+  for (int64_t value = latency_us; value > 1 && bucket < kBucketCount - 1;
+       value >>= 1) {
+    bucket++;
+  }
+  buckets[bucket]++;
+  count++;
+  total_us += latency_us;
+  max_us = std::max(max_us, latency_us);
+}
+
+int64_t QueryRouterBrowserSide::LatencyHistogram::GetPercentile(
+    double percentile) const {
+  if (count == 0)
+    return 0;
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(percentile / 100.0 * count + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets[i];
+    if (seen >= rank)
+      return std::min(max_us, static_cast<int64_t>(1) << (i + 1));
+  }
+  return max_us;
+}
+
+QueryRouterBrowserSide::QueryRouterBrowserSide()
+    : next_query_id_(1),
+      deadlines_(kTimerTickMs, kTimerSlotCount, NowMilliseconds()),
+      timer_tick_pending_(false) {}
+
+QueryRouterBrowserSide::~QueryRouterBrowserSide() {
+  DCHECK(queries_.empty());
+}
+
+bool QueryRouterBrowserSide::AddHandler(const std::string& query_function,
+                                        Handler* handler,
+                                        bool first) {
+  CEF_REQUIRE_UI_THREAD();
+  const MessageId namespace_id = GetMessageId(query_function);
+  std::vector<Handler*>& handlers = handlers_[namespace_id];
+  if (std::find(handlers.begin(), handlers.end(), handler) != handlers.end())
+    return false;
+  namespaces_[namespace_id] = query_function;
+  handlers.insert(first ? handlers.begin() : handlers.end(), handler);
+  return true;
+}
+
+void QueryRouterBrowserSide::RemoveHandler(Handler* handler) {
+  CEF_REQUIRE_UI_THREAD();
+  for (HandlerMap::iterator it = handlers_.begin(); it != handlers_.end();
+       ++it) {
+    std::vector<Handler*>& handlers = it->second;
+    handlers.erase(std::remove(handlers.begin(), handlers.end(), handler),
+                   handlers.end());
+  }
+
+  QueryMap::iterator it = queries_.begin();
+  while (it != queries_.end()) {
+    if (it->second.handler == handler)
+      it = CancelQuery(it, true);
+    else
+      ++it;
+  }
+
+  latency_.erase(handler);
+}
+
+size_t QueryRouterBrowserSide::GetPendingCount(
+    CefRefPtr<CefBrowser> browser) const {
+  CEF_REQUIRE_UI_THREAD();
+  if (!browser)
+    return queries_.size();
+
+  size_t count = 0;
+  for (QueryMap::const_iterator it = queries_.begin(); it != queries_.end();
+       ++it) {
+    if (it->second.browser->IsSame(browser))
+      count++;
+  }
+  return count;
+}
+
+const QueryRouterBrowserSide::LatencyHistogram*
+QueryRouterBrowserSide::GetLatencyHistogram(const Handler* handler) const {
+  CEF_REQUIRE_UI_THREAD();
+  LatencyMap::const_iterator it = latency_.find(handler);
+  return it != latency_.end() ? &it->second : nullptr;
+}
+
+void QueryRouterBrowserSide::LogLatencyHistograms() const {
+  CEF_REQUIRE_UI_THREAD();
+  for (HandlerMap::const_iterator it = handlers_.begin();
+       it != handlers_.end(); ++it) {
+    const std::string& name = namespaces_.find(it->first)->second;
+    for (size_t i = 0; i < it->second.size(); ++i) {
+      const LatencyHistogram* histogram = GetLatencyHistogram(it->second[i]);
+      if (!histogram)
+        continue;
+      LOG(INFO) << name << " handler " << i << ": count=" << histogram->count
+                << " p50_us=" << histogram->GetPercentile(50)
+                << " p99_us=" << histogram->GetPercentile(99)
+                << " max_us=" << histogram->max_us
+                << " timeouts=" << histogram->timeouts;
+    }
+  }
+}
+
+void QueryRouterBrowserSide::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
+  CEF_REQUIRE_UI_THREAD();
+  CancelPendingForBrowser(browser);
+}
+
+void QueryRouterBrowserSide::OnRenderProcessTerminated(
+    CefRefPtr<CefBrowser> browser) {
+  CEF_REQUIRE_UI_THREAD();
+  CancelPendingForBrowser(browser);
+}
+
+void QueryRouterBrowserSide::OnBeforeBrowse(CefRefPtr<CefBrowser> browser,
+                                            CefRefPtr<CefFrame> frame) {
+  CEF_REQUIRE_UI_THREAD();
+  if (frame->IsMain()) {
+    CancelPendingForBrowser(browser);
+    return;
+  }
+
+  const int64_t frame_id = frame->GetIdentifier();
+  QueryMap::iterator it = queries_.begin();
+  while (it != queries_.end()) {
+    if (it->second.browser->IsSame(browser) &&
+        it->second.frame->GetIdentifier() == frame_id) {
+      it = CancelQuery(it, false);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool QueryRouterBrowserSide::OnProcessMessageReceived(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefProcessId source_process,
+    CefRefPtr<CefProcessMessage> message) {
+  CEF_REQUIRE_UI_THREAD();
+
+  const std::string& name = message->GetName();
+  if (name == kQueryMessageName) {
+    OnQueryMessage(browser, frame, MessagePayload(message));
+    return true;
+  }
+  if (name == kCancelMessageName) {
+    OnCancelMessage(browser, MessagePayload(message));
+    return true;
+  }
+  if (name == kCreditMessageName) {
+    OnCreditMessage(browser, MessagePayload(message));
+    return true;
+  }
+  return false;
+}
+
+void QueryRouterBrowserSide::OnQueryMessage(CefRefPtr<CefBrowser> browser,
+                                            CefRefPtr<CefFrame> frame,
+                                            const MessagePayload& payload) {
+  QueryHeader header;
+  const char* body;
+  size_t body_size;
+  if (!ReadRouterMessage(payload, header, body, body_size))
+    return;
+
+  const int64_t query_id = next_query_id_++;
+  QueryInfo& info = queries_[query_id];
+  info.browser = browser;
+  info.frame = frame;
+  info.namespace_id = header.namespace_id;
+  info.context_id = header.context_id;
+  info.request_id = header.request_id;
+  info.persistent = !!header.persistent;
+  info.handler = nullptr;
+  info.start_us = NowMicroseconds();
+  requests_[RequestKey(browser->GetIdentifier(), header.context_id,
+                       header.request_id)] = query_id;
+
+  // The deadline is removed when the query is answered or erased.
+  if (header.timeout_ms > 0) {
+    deadlines_.Schedule(query_id, NowMilliseconds() + header.timeout_ms);
+    ScheduleTimerTick();
+  }
+
+  const std::string request(body, body_size);
+
+  HandlerMap::const_iterator handlers = handlers_.find(header.namespace_id);
+  if (handlers != handlers_.end()) {
+    // Copy the list because handlers may be removed during iteration.
+    const std::vector<Handler*> list = handlers->second;
+    for (size_t i = 0; i < list.size(); ++i) {
+      // Set the handler first because it may respond synchronously.
+      info.handler = list[i];
+      CefRefPtr<Callback> callback = new CallbackImpl(this, query_id);
+      if (list[i]->OnQuery(browser, frame, query_id, request, info.persistent,
+                           callback)) {
+        // Grant the initial window unless the handler already completed the
+        // query.
+        if (header.persistent && header.credits > 0 &&
+            queries_.find(query_id) != queries_.end()) {
+          list[i]->OnQueryCredit(browser, frame, query_id, header.credits);
+        }
+        return;
+      }
+      // The handler may have responded before declining the query.
+      if (queries_.find(query_id) == queries_.end())
+        return;
+    }
+  }
+
+  // No handler accepted the query.
+  QueryMap::iterator it = queries_.find(query_id);
+  SendResponse(it->second, false, kQueryUnhandledError,
+               kUnhandledErrorMessage);
+  EraseQuery(it);
+}
+
+void QueryRouterBrowserSide::OnCancelMessage(CefRefPtr<CefBrowser> browser,
+                                             const MessagePayload& payload) {
+  CancelHeader header;
+  const char* body;
+  size_t body_size;
+  if (!ReadRouterMessage(payload, header, body, body_size))
+    return;
+
+  const int browser_id = browser->GetIdentifier();
+  if (header.request_id != kAllRequests) {
+    RequestMap::const_iterator request = requests_.find(
+        RequestKey(browser_id, header.context_id, header.request_id));
+    if (request == requests_.end())
+      return;
+    QueryMap::iterator it = queries_.find(request->second);
+    if (it->second.namespace_id == header.namespace_id)
+      CancelQuery(it, false);
+    return;
+  }
+
+  // Cancel all queries of the context. Query IDs are found via the request
+  // map, which is ordered by context.
+  RequestMap::const_iterator request = requests_.lower_bound(
+      RequestKey(browser_id, header.context_id, INT32_MIN));
+  std::vector<int64_t> query_ids;
+  for (; request != requests_.end() &&
+         std::get<0>(request->first) == browser_id &&
+         std::get<1>(request->first) == header.context_id;
+       ++request) {
+    query_ids.push_back(request->second);
+  }
+  for (size_t i = 0; i < query_ids.size(); ++i) {
+    QueryMap::iterator it = queries_.find(query_ids[i]);
+    if (it != queries_.end())
+      CancelQuery(it, false);
+  }
+}
+
+void QueryRouterBrowserSide::OnCreditMessage(CefRefPtr<CefBrowser> browser,
+                                             const MessagePayload& payload) {
+  CreditHeader header;
+  const char* body;
+  size_t body_size;
+  if (!ReadRouterMessage(payload, header, body, body_size) ||
+      header.credits <= 0) {
+    return;
+  }
+
+  RequestMap::const_iterator request = requests_.find(RequestKey(
+      browser->GetIdentifier(), header.context_id, header.request_id));
+  if (request == requests_.end())
+    return;
+  const int64_t query_id = request->second;
+  const QueryInfo& info = queries_.find(query_id)->second;
+  if (info.namespace_id != header.namespace_id || !info.persistent ||
+      !info.handler) {
+    return;
+  }
+  info.handler->OnQueryCredit(info.browser, info.frame, query_id,
+                              header.credits);
+}
+
+void QueryRouterBrowserSide::OnCallbackSuccess(int64_t query_id,
+                                               const std::string& response) {
+  QueryMap::iterator it = queries_.find(query_id);
+  if (it == queries_.end())
+    return;
+
+  RecordResponse(it);
+  SendResponse(it->second, true, 0, response);
+  if (!it->second.persistent)
+    EraseQuery(it);
+}
+
+void QueryRouterBrowserSide::OnCallbackFailure(
+    int64_t query_id,
+    int error_code,
+    const std::string& error_message) {
+  QueryMap::iterator it = queries_.find(query_id);
+  if (it == queries_.end())
+    return;
+
+  RecordResponse(it);
+  SendResponse(it->second, false, error_code, error_message);
+  EraseQuery(it);
+}
+
+void QueryRouterBrowserSide::RecordResponse(QueryMap::iterator it) {
+  QueryInfo& info = it->second;
+  if (info.start_us == 0)
+    return;
+  if (info.handler)
+    latency_[info.handler].Add(NowMicroseconds() - info.start_us);
+  info.start_us = 0;
+
+  // A persistent query only has to respond once before its deadline.
+  deadlines_.Cancel(it->first);
+}
+
+void QueryRouterBrowserSide::OnTimerTick() {
+  CEF_REQUIRE_UI_THREAD();
+  timer_tick_pending_ = false;
+
+  std::vector<int64_t> expired;
+  deadlines_.Advance(NowMilliseconds(), expired);
+  for (size_t i = 0; i < expired.size(); ++i) {
+    QueryMap::iterator it = queries_.find(expired[i]);
+    if (it == queries_.end())
+      continue;
+    if (it->second.handler)
+      latency_[it->second.handler].timeouts++;
+    SendResponse(it->second, false, kQueryTimeoutError, kTimeoutErrorMessage);
+    // Notify the handler so it can release the query state.
+    CancelQuery(it, false);
+  }
+
+  ScheduleTimerTick();
+}
+
+void QueryRouterBrowserSide::ScheduleTimerTick() {
+  if (timer_tick_pending_ || deadlines_.empty())
+    return;
+  timer_tick_pending_ = true;
+  CefPostDelayedTask(TID_UI,
+                     base::BindOnce(&QueryRouterBrowserSide::OnTimerTick,
+                                    CefRefPtr<QueryRouterBrowserSide>(this)),
+                     deadlines_.tick_ms());
+}
+
+void QueryRouterBrowserSide::SendResponse(const QueryInfo& info,
+                                          bool success,
+                                          int error_code,
+                                          const std::string& body) {
+  if (!info.frame->IsValid())
+    return;
+
+  ResponseHeader header;
+  header.context_id = info.context_id;
+  header.request_id = info.request_id;
+  header.error_code = error_code;
+  header.success = success ? 1 : 0;
+  CefRefPtr<CefProcessMessage> message = CreateRouterMessage(
+      kResponseMessageName, header, body.data(), body.size());
+  if (message)
+    info.frame->SendProcessMessage(PID_RENDERER, message);
+}
+
+QueryRouterBrowserSide::QueryMap::iterator QueryRouterBrowserSide::EraseQuery(
+    QueryMap::iterator it) {
+  const QueryInfo& info = it->second;
+  requests_.erase(RequestKey(info.browser->GetIdentifier(), info.context_id,
+                             info.request_id));
+  deadlines_.Cancel(it->first);
+  return queries_.erase(it);
+}
+
+QueryRouterBrowserSide::QueryMap::iterator QueryRouterBrowserSide::CancelQuery(
+    QueryMap::iterator it,
+    bool notify_renderer) {
+  const QueryInfo info = it->second;
+  const int64_t query_id = it->first;
+  EraseQuery(it);
+
+  if (notify_renderer)
+    SendResponse(info, false, kQueryCanceledError, kCanceledErrorMessage);
+  if (info.handler)
+    info.handler->OnQueryCanceled(info.browser, info.frame, query_id);
+
+  // The handler may have completed other queries, so find the next query
+  // again.
+  return queries_.upper_bound(query_id);
+}
+
+void QueryRouterBrowserSide::CancelPendingForBrowser(
+    CefRefPtr<CefBrowser> browser) {
+  QueryMap::iterator it = queries_.begin();
+  while (it != queries_.end()) {
+    if (it->second.browser->IsSame(browser))
+      it = CancelQuery(it, false);
+    else
+      ++it;
+  }
+}
+
+}  // namespace message_router
@@ -0,0 +1,232 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_BROWSER_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_BROWSER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "include/cef_browser.h"
+#include "include/cef_process_message.h"
+
+#include "examples/message_router/query_router.h"
+#include "examples/message_router/timer_wheel.h"
+
+namespace message_router {
+
+// Browser side of a query router that serves several JavaScript namespaces.
+// It replaces one CefMessageRouterBrowserSide per namespace: pending queries
+// of all namespaces and browsers are tracked in one table, and each query is
+// offered only to the handlers of its own namespace. A single instance may be
+// shared by multiple CefClient instances. Queries sent with a timeout fail
+// with kQueryTimeoutError if the handler has not responded before the
+// deadline. Deadlines are tracked in a TimerWheel that ticks on the UI thread
+// while any deadline is pending. Must be used on the browser process UI thread
+// unless otherwise indicated.
+class QueryRouterBrowserSide : public CefBaseRefCounted {
+ public:
+  // Callback for responding to a query. May be called on any thread.
+  class Callback : public CefBaseRefCounted {
+   public:
+    // Send a successful response. May be called multiple times for persistent
+    // queries.
+    virtual void Success(const std::string& response) = 0;
+
+    // Send a failure response. Completes the query.
+    virtual void Failure(int error_code, const std::string& error_message) = 0;
+  };
+
+  // Handler for the queries of a namespace.
+  class Handler {
+   public:
+    typedef QueryRouterBrowserSide::Callback Callback;
+
+    // Called when a query is received. Return true to handle the query and
+    // respond via |callback| now or later, or false to offer the query to the
+    // next handler of the namespace. |query_id| is unique for the lifespan of
+    // the router.
+    virtual bool OnQuery(CefRefPtr<CefBrowser> browser,
+                         CefRefPtr<CefFrame> frame,
+                         int64_t query_id,
+                         const std::string& request,
+                         bool persistent,
+                         CefRefPtr<Callback> callback) = 0;
+
+    // Called when a query handled by this handler is canceled before it
+    // completed. |callback| must not be used after this call.
+    virtual void OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                                 CefRefPtr<CefFrame> frame,
+                                 int64_t query_id) {}
+
+    // Called when the renderer grants |credits| more responses to a
+    // persistent query handled by this handler. Each successful response
+    // consumes one credit. Also called with the initial window right after
+    // OnQuery accepts a persistent query. Handlers that stream responses
+    // should not send more responses than they have been granted.
+    virtual void OnQueryCredit(CefRefPtr<CefBrowser> browser,
+                               CefRefPtr<CefFrame> frame,
+                               int64_t query_id,
+                               int32_t credits) {}
+
+    virtual ~Handler() {}
+  };
+
+  // Distribution of the time between receiving a query and the first
+  // response from its handler.
+  struct LatencyHistogram {
+    // Bucket i counts latencies in [2^i, 2^(i+1)) microseconds. Bucket 0 also
+    // counts latencies below one microsecond.
+    static const size_t kBucketCount = 32;
+
+    LatencyHistogram();
+
+    void Add(int64_t latency_us);
+
+    // Returns the upper bound in microseconds of the bucket that contains
+    // the |percentile| (0-100) latency, or 0 if no latency was recorded.
+    int64_t GetPercentile(double percentile) const;
+
+    uint64_t buckets[kBucketCount];
+    uint64_t count;
+    int64_t total_us;
+    int64_t max_us;
+    // Number of queries that failed with kQueryTimeoutError.
+    uint64_t timeouts;
+  };
+
+  QueryRouterBrowserSide();
+
+  // Add |handler| for queries sent with the |query_function| JavaScript
+  // function. If |first| is true the handler is offered queries before the
+  // existing handlers of the namespace. Returns false if |handler| is already
+  // registered for the namespace.
+  bool AddHandler(const std::string& query_function,
+                  Handler* handler,
+                  bool first);
+
+  // Remove |handler| from all namespaces. Pending queries handled by
+  // |handler| are canceled.
+  void RemoveHandler(Handler* handler);
+
+  // Returns the number of pending queries for |browser|, or for all browsers
+  // if |browser| is nullptr.
+  size_t GetPendingCount(CefRefPtr<CefBrowser> browser) const;
+
+  // Returns the latency histogram of |handler|, or nullptr if |handler| has
+  // not responded to or timed out any query.
+  const LatencyHistogram* GetLatencyHistogram(const Handler* handler) const;
+
+  // Log a summary of the latency histogram of each handler.
+  void LogLatencyHistograms() const;
+
+  // Call from the CefClient methods of the same name.
+  void OnBeforeClose(CefRefPtr<CefBrowser> browser);
+  void OnRenderProcessTerminated(CefRefPtr<CefBrowser> browser);
+  void OnBeforeBrowse(CefRefPtr<CefBrowser> browser,
+                      CefRefPtr<CefFrame> frame);
+
+  // Returns true if |message| was sent by a QueryRouterRendererSide.
+  bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
+                                CefRefPtr<CefFrame> frame,
+                                CefProcessId source_process,
+                                CefRefPtr<CefProcessMessage> message);
+
+ private:
+  class CallbackImpl;
+
+  struct QueryInfo {
+    CefRefPtr<CefBrowser> browser;
+    CefRefPtr<CefFrame> frame;
+    MessageId namespace_id;
+    int32_t context_id;
+    int32_t request_id;
+    bool persistent;
+    Handler* handler;
+    // Time the query was received. Reset to zero once the handler has
+    // responded.
+    int64_t start_us;
+  };
+
+  // Map of query ID to pending query.
+  typedef std::map<int64_t, QueryInfo> QueryMap;
+
+  // Map of (browser ID, context ID, request ID) to query ID.
+  typedef std::tuple<int, int32_t, int32_t> RequestKey;
+  typedef std::map<RequestKey, int64_t> RequestMap;
+
+  // Map of namespace ID to handlers in the order they are offered queries.
+  typedef std::unordered_map<MessageId, std::vector<Handler*>> HandlerMap;
+
+  // Map of namespace ID to query function name.
+  typedef std::unordered_map<MessageId, std::string> NamespaceMap;
+
+  // Map of handler to latency histogram.
+  typedef std::unordered_map<const Handler*, LatencyHistogram> LatencyMap;
+
+  ~QueryRouterBrowserSide() override;
+
+  void OnQueryMessage(CefRefPtr<CefBrowser> browser,
+                      CefRefPtr<CefFrame> frame,
+                      const MessagePayload& payload);
+  void OnCancelMessage(CefRefPtr<CefBrowser> browser,
+                       const MessagePayload& payload);
+  void OnCreditMessage(CefRefPtr<CefBrowser> browser,
+                       const MessagePayload& payload);
+
+  // Called by CallbackImpl on the UI thread.
+  void OnCallbackSuccess(int64_t query_id, const std::string& response);
+  void OnCallbackFailure(int64_t query_id,
+                         int error_code,
+                         const std::string& error_message);
+
+  // Record the latency of the first response to the query and clear its
+  // deadline.
+  void RecordResponse(QueryMap::iterator it);
+
+  // Fail queries whose deadline has passed. Called on the UI thread once per
+  // timer wheel tick while any deadline is pending.
+  void OnTimerTick();
+
+  // Post OnTimerTick if deadlines are pending and no tick is posted.
+  void ScheduleTimerTick();
+
+  // Send a response for |info|.
+  void SendResponse(const QueryInfo& info,
+                    bool success,
+                    int error_code,
+                    const std::string& body);
+
+  // Remove the query. Returns an iterator to the next query.
+  QueryMap::iterator EraseQuery(QueryMap::iterator it);
+
+  // Cancel the pending query. If |notify_renderer| is true the renderer is
+  // sent a failure response. Returns an iterator to the next query.
+  QueryMap::iterator CancelQuery(QueryMap::iterator it, bool notify_renderer);
+
+  // Cancel all pending queries for |browser| without notifying the renderer.
+  void CancelPendingForBrowser(CefRefPtr<CefBrowser> browser);
+
+  HandlerMap handlers_;
+  NamespaceMap namespaces_;
+  QueryMap queries_;
+  RequestMap requests_;
+  int64_t next_query_id_;
+
+  LatencyMap latency_;
+  TimerWheel deadlines_;
+  bool timer_tick_pending_;
+
+  IMPLEMENT_REFCOUNTING(QueryRouterBrowserSide);
+  DISALLOW_COPY_AND_ASSIGN(QueryRouterBrowserSide);
+};
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_BROWSER_H_
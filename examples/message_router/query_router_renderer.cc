@@ -0,0 +1,321 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/message_router/query_router_renderer.h"
+
+#include "include/wrapper/cef_helpers.h"
+
+namespace message_router {
+
+// Implements the query and cancel functions of a namespace.
+class QueryRouterRendererSide::V8HandlerImpl : public CefV8Handler {
+ public:
+  V8HandlerImpl(CefRefPtr<QueryRouterRendererSide> router,
+                size_t namespace_index,
+                bool cancel)
+      : router_(router), namespace_index_(namespace_index), cancel_(cancel) {}
+
+  bool Execute(const CefString& name,
+               CefRefPtr<CefV8Value> object,
+               const CefV8ValueList& arguments,
+               CefRefPtr<CefV8Value>& retval,
+               CefString& exception) override {
+    CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
+
+    if (cancel_) {
+      if (arguments.size() != 1 || !arguments[0]->IsInt()) {
+        exception = "Invalid arguments; expecting a single integer";
+        return true;
+      }
+      retval = CefV8Value::CreateBool(router_->SendCancel(
+          context, namespace_index_, arguments[0]->GetIntValue()));
+      return true;
+    }
+
+    if (arguments.size() != 1 || !arguments[0]->IsObject()) {
+      exception = "Invalid arguments; expecting a single object";
+      return true;
+    }
+
+    CefRefPtr<CefV8Value> arg = arguments[0];
+    CefRefPtr<CefV8Value> request = arg->GetValue("request");
+    if (!request || !request->IsString()) {
+      exception = "Invalid arguments; object member 'request' is required "
+                  "and must have type string";
+      return true;
+    }
+
+    CefRefPtr<CefV8Value> success_callback = GetFunction(arg, "onSuccess");
+    CefRefPtr<CefV8Value> failure_callback = GetFunction(arg, "onFailure");
+    CefRefPtr<CefV8Value> persistent = arg->GetValue("persistent");
+
+    int32_t credit_window = kDefaultCreditWindow;
+    int32_t timeout_ms = 0;
+    if (!GetPositiveInt(arg, "credits", credit_window) ||
+        !GetPositiveInt(arg, "timeout", timeout_ms)) {
+      exception = "Invalid arguments; object members 'credits' and 'timeout' "
+                  "must be positive integers";
+      return true;
+    }
+
+    const int32_t request_id = router_->SendQuery(
+        context, namespace_index_, request->GetStringValue(),
+        persistent && persistent->IsBool() && persistent->GetBoolValue(),
+        credit_window, timeout_ms, success_callback, failure_callback);
+    retval = CefV8Value::CreateInt(request_id);
+    return true;
+  }
+
+ private:
+  // Read the optional member |key| of |object| into |value|. Returns false if
+  // the member exists and is not a positive integer.
+  static bool GetPositiveInt(CefRefPtr<CefV8Value> object,
+                             const char* key,
+                             int32_t& value) {
+    CefRefPtr<CefV8Value> member = object->GetValue(key);
+    if (!member || member->IsUndefined())
+      return true;
+    if (!member->IsInt() || member->GetIntValue() <= 0)
+      return false;
+    value = member->GetIntValue();
+    return true;
+  }
+
+  // Returns the member |key| of |object| if it is a function.
+  static CefRefPtr<CefV8Value> GetFunction(CefRefPtr<CefV8Value> object,
+                                           const char* key) {
+    CefRefPtr<CefV8Value> value = object->GetValue(key);
+    if (value && value->IsFunction())
+      return value;
+    return nullptr;
+  }
+
+  const CefRefPtr<QueryRouterRendererSide> router_;
+  const size_t namespace_index_;
+  const bool cancel_;
+
+  IMPLEMENT_REFCOUNTING(V8HandlerImpl);
+  DISALLOW_COPY_AND_ASSIGN(V8HandlerImpl);
+};
+
+QueryRouterRendererSide::QueryRouterRendererSide()
+    : next_context_id_(1), next_request_id_(1) {}
+
+QueryRouterRendererSide::~QueryRouterRendererSide() {}
+
+void QueryRouterRendererSide::AddNamespace(
+    const std::string& query_function,
+    const std::string& cancel_function) {
+  DCHECK(contexts_.empty());
+  Namespace ns;
+  ns.query_function = query_function;
+  ns.cancel_function = cancel_function;
+  ns.id = GetMessageId(query_function);
+  namespaces_.push_back(ns);
+}
+
+void QueryRouterRendererSide::OnContextCreated(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefRefPtr<CefV8Context> context) {
+  CEF_REQUIRE_RENDERER_THREAD();
+  contexts_[next_context_id_++] = context;
+
+  const CefV8Value::PropertyAttribute attributes =
+      static_cast<CefV8Value::PropertyAttribute>(
+          V8_PROPERTY_ATTRIBUTE_READONLY | V8_PROPERTY_ATTRIBUTE_DONTENUM |
+          V8_PROPERTY_ATTRIBUTE_DONTDELETE);
+
+  CefRefPtr<CefV8Value> window = context->GetGlobal();
+  for (size_t i = 0; i < namespaces_.size(); ++i) {
+    const Namespace& ns = namespaces_[i];
+    window->SetValue(
+        ns.query_function,
+        CefV8Value::CreateFunction(ns.query_function,
+                                   new V8HandlerImpl(this, i, false)),
+        attributes);
+    window->SetValue(
+        ns.cancel_function,
+        CefV8Value::CreateFunction(ns.cancel_function,
+                                   new V8HandlerImpl(this, i, true)),
+        attributes);
+  }
+}
+
+void QueryRouterRendererSide::OnContextReleased(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefRefPtr<CefV8Context> context) {
+  CEF_REQUIRE_RENDERER_THREAD();
+  const int32_t context_id = GetContextId(context);
+  if (context_id == 0)
+    return;
+
+  // Cancel all pending requests of the context in the browser process.
+  RequestMap::iterator first =
+      requests_.lower_bound(RequestKey(context_id, INT32_MIN));
+  RequestMap::iterator last =
+      requests_.upper_bound(RequestKey(context_id, INT32_MAX));
+  if (first != last) {
+    requests_.erase(first, last);
+
+    CancelHeader header;
+    header.namespace_id = 0;
+    header.context_id = context_id;
+    header.request_id = kAllRequests;
+    CefRefPtr<CefProcessMessage> message =
+        CreateRouterMessage(kCancelMessageName, header, nullptr, 0);
+    if (message)
+      frame->SendProcessMessage(PID_BROWSER, message);
+  }
+
+  contexts_.erase(context_id);
+}
+
+bool QueryRouterRendererSide::OnProcessMessageReceived(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefProcessId source_process,
+    CefRefPtr<CefProcessMessage> message) {
+  CEF_REQUIRE_RENDERER_THREAD();
+  if (message->GetName() != kResponseMessageName)
+    return false;
+
+  const MessagePayload payload(message);
+  ResponseHeader header;
+  const char* body;
+  size_t body_size;
+  if (ReadRouterMessage(payload, header, body, body_size))
+    OnResponse(header, body, body_size);
+  return true;
+}
+
+int32_t QueryRouterRendererSide::SendQuery(
+    CefRefPtr<CefV8Context> context,
+    size_t namespace_index,
+    const std::string& request,
+    bool persistent,
+    int32_t credits,
+    int32_t timeout_ms,
+    CefRefPtr<CefV8Value> success_callback,
+    CefRefPtr<CefV8Value> failure_callback) {
+  const int32_t context_id = GetContextId(context);
+  if (context_id == 0)
+    return 0;
+
+  QueryHeader header;
+  header.namespace_id = namespaces_[namespace_index].id;
+  header.context_id = context_id;
+  header.request_id = next_request_id_++;
+  header.credits = persistent ? credits : 0;
+  header.timeout_ms = timeout_ms;
+  header.persistent = persistent ? 1 : 0;
+  CefRefPtr<CefProcessMessage> message = CreateRouterMessage(
+      kQueryMessageName, header, request.data(), request.size());
+  if (!message)
+    return 0;
+
+  RequestInfo& info = requests_[RequestKey(context_id, header.request_id)];
+  info.namespace_index = namespace_index;
+  info.success_callback = success_callback;
+  info.failure_callback = failure_callback;
+  info.persistent = persistent;
+  info.credits = header.credits;
+  info.consumed = 0;
+
+  context->GetFrame()->SendProcessMessage(PID_BROWSER, message);
+  return header.request_id;
+}
+
+bool QueryRouterRendererSide::SendCancel(CefRefPtr<CefV8Context> context,
+                                         size_t namespace_index,
+                                         int32_t request_id) {
+  const int32_t context_id = GetContextId(context);
+  RequestMap::iterator it = requests_.find(RequestKey(context_id, request_id));
+  if (it == requests_.end() || it->second.namespace_index != namespace_index)
+    return false;
+  requests_.erase(it);
+
+  CancelHeader header;
+  header.namespace_id = namespaces_[namespace_index].id;
+  header.context_id = context_id;
+  header.request_id = request_id;
+  CefRefPtr<CefProcessMessage> message =
+      CreateRouterMessage(kCancelMessageName, header, nullptr, 0);
+  if (message)
+    context->GetFrame()->SendProcessMessage(PID_BROWSER, message);
+  return true;
+}
+
+int32_t QueryRouterRendererSide::GetContextId(
+    CefRefPtr<CefV8Context> context) const {
+  for (ContextMap::const_iterator it = contexts_.begin();
+       it != contexts_.end(); ++it) {
+    if (it->second->IsSame(context))
+      return it->first;
+  }
+  return 0;
+}
+
+void QueryRouterRendererSide::OnResponse(const ResponseHeader& header,
+                                         const char* body,
+                                         size_t body_size) {
+  const RequestKey key(header.context_id, header.request_id);
+  RequestMap::iterator it = requests_.find(key);
+  if (it == requests_.end())
+    return;
+  ContextMap::const_iterator context = contexts_.find(header.context_id);
+  if (context == contexts_.end() || !context->second->IsValid()) {
+    requests_.erase(it);
+    return;
+  }
+
+  // Keep the callbacks because executing them may cancel the request.
+  const RequestInfo info = it->second;
+  if (!header.success || !info.persistent)
+    requests_.erase(it);
+
+  CefV8ValueList args;
+  CefRefPtr<CefV8Value> callback;
+  if (header.success) {
+    callback = info.success_callback;
+    args.push_back(CefV8Value::CreateString(std::string(body, body_size)));
+  } else {
+    callback = info.failure_callback;
+    args.push_back(CefV8Value::CreateInt(header.error_code));
+    args.push_back(CefV8Value::CreateString(std::string(body, body_size)));
+  }
+  if (callback)
+    callback->ExecuteFunctionWithContext(context->second, nullptr, args);
+
+  if (header.success && info.persistent)
+    OnResponseConsumed(key);
+}
+
+void QueryRouterRendererSide::OnResponseConsumed(const RequestKey& key) {
+  // The callback may have canceled the request or released the context.
+  RequestMap::iterator it = requests_.find(key);
+  if (it == requests_.end())
+    return;
+  ContextMap::const_iterator context = contexts_.find(key.first);
+  if (context == contexts_.end())
+    return;
+
+  RequestInfo& info = it->second;
+  if (++info.consumed < (info.credits + 1) / 2)
+    return;
+
+  CreditHeader header;
+  header.namespace_id = namespaces_[info.namespace_index].id;
+  header.context_id = key.first;
+  header.request_id = key.second;
+  header.credits = info.consumed;
+  info.consumed = 0;
+  CefRefPtr<CefProcessMessage> message =
+      CreateRouterMessage(kCreditMessageName, header, nullptr, 0);
+  if (message)
+    context->second->GetFrame()->SendProcessMessage(PID_BROWSER, message);
+}
+
+}  // namespace message_router
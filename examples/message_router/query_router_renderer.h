@@ -0,0 +1,132 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_RENDERER_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_RENDERER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/cef_process_message.h"
+#include "include/cef_v8.h"
+
+#include "examples/message_router/query_router.h"
+
+namespace message_router {
+
+// Renderer side of the query router. Adds the query and cancel functions of
+// each namespace to the window object of every V8 context and sends queries
+// to QueryRouterBrowserSide. The query function takes an object with the
+// following members and returns the request ID:
+//
+//   request: string sent to the browser process handler.
+//   persistent: optional boolean. If true the query remains pending after a
+//       successful response.
+//   credits: optional positive integer. Number of responses a persistent
+//       query may receive before earlier responses have been consumed.
+//       Defaults to kDefaultCreditWindow. Credits are returned to the browser
+//       process as the onSuccess callback consumes responses.
+//   timeout: optional positive integer. Milliseconds the browser process
+//       handler has to respond before the query fails with
+//       kQueryTimeoutError. Persistent queries only need to respond once.
+//   onSuccess: optional function(response).
+//   onFailure: optional function(error_code, error_message).
+//
+// The cancel function takes a request ID returned by the query function of
+// the same namespace. Must be used on the renderer process main thread.
+class QueryRouterRendererSide : public CefBaseRefCounted {
+ public:
+  QueryRouterRendererSide();
+
+  // Add a namespace served by the JavaScript functions |query_function| and
+  // |cancel_function|. Call before the first context is created.
+  void AddNamespace(const std::string& query_function,
+                    const std::string& cancel_function);
+
+  // Call from the CefRenderProcessHandler methods of the same name.
+  void OnContextCreated(CefRefPtr<CefBrowser> browser,
+                        CefRefPtr<CefFrame> frame,
+                        CefRefPtr<CefV8Context> context);
+  void OnContextReleased(CefRefPtr<CefBrowser> browser,
+                         CefRefPtr<CefFrame> frame,
+                         CefRefPtr<CefV8Context> context);
+
+  // Returns true if |message| was sent by QueryRouterBrowserSide.
+  bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
+                                CefRefPtr<CefFrame> frame,
+                                CefProcessId source_process,
+                                CefRefPtr<CefProcessMessage> message);
+
+ private:
+  class V8HandlerImpl;
+
+  struct Namespace {
+    std::string query_function;
+    std::string cancel_function;
+    MessageId id;
+  };
+
+  struct RequestInfo {
+    size_t namespace_index;
+    CefRefPtr<CefV8Value> success_callback;
+    CefRefPtr<CefV8Value> failure_callback;
+    bool persistent;
+    // Credit window, and number of responses consumed since credits were
+    // last returned.
+    int32_t credits;
+    int32_t consumed;
+  };
+
+  // Map of (context ID, request ID) to pending request.
+  typedef std::pair<int32_t, int32_t> RequestKey;
+  typedef std::map<RequestKey, RequestInfo> RequestMap;
+
+  // Map of context ID to context.
+  typedef std::map<int32_t, CefRefPtr<CefV8Context>> ContextMap;
+
+  ~QueryRouterRendererSide() override;
+
+  // Called by V8HandlerImpl. Returns the request ID, or 0 on failure.
+  int32_t SendQuery(CefRefPtr<CefV8Context> context,
+                    size_t namespace_index,
+                    const std::string& request,
+                    bool persistent,
+                    int32_t credits,
+                    int32_t timeout_ms,
+                    CefRefPtr<CefV8Value> success_callback,
+                    CefRefPtr<CefV8Value> failure_callback);
+
+  // Called by V8HandlerImpl. Returns true if the request was pending.
+  bool SendCancel(CefRefPtr<CefV8Context> context,
+                  size_t namespace_index,
+                  int32_t request_id);
+
+  // Returns the ID of |context|, or 0 if it is not known.
+  int32_t GetContextId(CefRefPtr<CefV8Context> context) const;
+
+  void OnResponse(const ResponseHeader& header,
+                  const char* body,
+                  size_t body_size);
+
+  // Called after the page consumed a successful response to a persistent
+  // request. Returns credits once half of the window has been consumed.
+  void OnResponseConsumed(const RequestKey& key);
+
+  std::vector<Namespace> namespaces_;
+  ContextMap contexts_;
+  RequestMap requests_;
+  int32_t next_context_id_;
+  int32_t next_request_id_;
+
+  IMPLEMENT_REFCOUNTING(QueryRouterRendererSide);
+  DISALLOW_COPY_AND_ASSIGN(QueryRouterRendererSide);
+};
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_ROUTER_RENDERER_H_
@@ -0,0 +1,175 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/message_router/query_stream.h"
+
+#include <utility>
+
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace message_router {
+
+namespace {
+
+const char kStreamEndedMessage[] = "The stream has ended";
+
+}  // namespace
+
+const int QueryStream::kStreamEndedError = -4;
+
+QueryStream::QueryStream(CefRefPtr<QueryRouterBrowserSide::Callback> callback,
+                         base::OnceClosure on_close)
+    : callback_(callback),
+      credits_(0),
+      closed_(false),
+      on_close_(std::move(on_close)) {}
+
+bool QueryStream::Write(const std::string& chunk) {
+  {
+    base::AutoLock lock_scope(lock_);
+    if (closed_ || credits_ == 0)
+      return false;
+    credits_--;
+  }
+  callback_->Success(chunk);
+  return true;
+}
+
+void QueryStream::End() {
+  Fail(kStreamEndedError, kStreamEndedMessage);
+}
+
+void QueryStream::Fail(int error_code, const std::string& error_message) {
+  if (!Close())
+    return;
+  callback_->Failure(error_code, error_message);
+
+  base::OnceClosure on_close;
+  {
+    base::AutoLock lock_scope(lock_);
+    on_close = std::move(on_close_);
+  }
+  if (!on_close)
+    return;
+  if (CefCurrentlyOn(TID_UI))
+    std::move(on_close).Run();
+  else
+    CefPostTask(TID_UI, std::move(on_close));
+}
+
+void QueryStream::SetWritableCallback(const base::RepeatingClosure& callback) {
+  base::AutoLock lock_scope(lock_);
+  if (!closed_)
+    writable_callback_ = callback;
+}
+
+int32_t QueryStream::GetCredits() const {
+  base::AutoLock lock_scope(lock_);
+  return closed_ ? 0 : credits_;
+}
+
+bool QueryStream::IsClosed() const {
+  base::AutoLock lock_scope(lock_);
+  return closed_;
+}
+
+void QueryStream::AddCredits(int32_t credits) {
+  CEF_REQUIRE_UI_THREAD();
+  base::RepeatingClosure writable_callback;
+  {
+    base::AutoLock lock_scope(lock_);
+    if (closed_)
+      return;
+    if (credits_ == 0)
+      writable_callback = writable_callback_;
+    credits_ += credits;
+  }
+  // Run without the lock because the callback will usually write.
+  if (writable_callback)
+    writable_callback.Run();
+}
+
+void QueryStream::Cancel() {
+  CEF_REQUIRE_UI_THREAD();
+  Close();
+  base::AutoLock lock_scope(lock_);
+  on_close_ = base::OnceClosure();
+}
+
+bool QueryStream::Close() {
+  base::RepeatingClosure writable_callback;
+  {
+    base::AutoLock lock_scope(lock_);
+    if (closed_)
+      return false;
+    closed_ = true;
+    credits_ = 0;
+    // Release the callback outside of the lock in case it holds the last
+    // reference to the producer.
+    writable_callback = std::move(writable_callback_);
+  }
+  return true;
+}
+
+StreamQueryHandler::StreamQueryHandler() {}
+
+StreamQueryHandler::~StreamQueryHandler() {
+  DCHECK(streams_.empty());
+}
+
+bool StreamQueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
+                                 CefRefPtr<CefFrame> frame,
+                                 int64_t query_id,
+                                 const std::string& request,
+                                 bool persistent,
+                                 CefRefPtr<Callback> callback) {
+  CEF_REQUIRE_UI_THREAD();
+  if (!persistent)
+    return false;
+
+  // Handlers are expected to outlive their streams.
+  CefRefPtr<QueryStream> stream = new QueryStream(
+      callback, base::BindOnce(&StreamQueryHandler::OnStreamClosed,
+                               base::Unretained(this), query_id));
+  if (!OnStreamQuery(browser, frame, request, stream)) {
+    stream->Cancel();
+    return false;
+  }
+  if (!stream->IsClosed())
+    streams_[query_id] = stream;
+  return true;
+}
+
+void StreamQueryHandler::OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                                         CefRefPtr<CefFrame> frame,
+                                         int64_t query_id) {
+  CEF_REQUIRE_UI_THREAD();
+  StreamMap::iterator it = streams_.find(query_id);
+  if (it == streams_.end())
+    return;
+  CefRefPtr<QueryStream> stream = it->second;
+  streams_.erase(it);
+  stream->Cancel();
+}
+
+void StreamQueryHandler::OnQueryCredit(CefRefPtr<CefBrowser> browser,
+                                       CefRefPtr<CefFrame> frame,
+                                       int64_t query_id,
+                                       int32_t credits) {
+  CEF_REQUIRE_UI_THREAD();
+  StreamMap::iterator it = streams_.find(query_id);
+  if (it == streams_.end())
+    return;
+  // Keep a reference because the writable callback may close the stream.
+  CefRefPtr<QueryStream> stream = it->second;
+  stream->AddCredits(credits);
+}
+
+void StreamQueryHandler::OnStreamClosed(int64_t query_id) {
+  CEF_REQUIRE_UI_THREAD();
+  streams_.erase(query_id);
+}
+
+}  // namespace message_router
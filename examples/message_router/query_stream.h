@@ -0,0 +1,129 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_STREAM_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_STREAM_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_lock.h"
+
+#include "examples/message_router/query_router_browser.h"
+
+namespace message_router {
+
+// Producer side of a persistent query that streams many responses. Each
+// response is sent with QueryRouterBrowserSide::Callback::Success and uses
+// one of the credits granted by the renderer as the page consumes responses,
+// so the producer can never get further ahead of the page than the credit
+// window. Methods may be called on any thread unless otherwise indicated.
+class QueryStream : public CefBaseRefCounted {
+ public:
+  // Error code sent to the JavaScript onFailure callback by End().
+  static const int kStreamEndedError;
+
+  // Send |chunk| as the next response. Returns false without sending if no
+  // credits are left or the stream is closed. Use SetWritableCallback to
+  // learn when more credits arrive.
+  bool Write(const std::string& chunk);
+
+  // Complete the query with kStreamEndedError. Closes the stream.
+  void End();
+
+  // Complete the query with the specified error. Closes the stream.
+  void Fail(int error_code, const std::string& error_message);
+
+  // Set the callback that is run on the browser process UI thread when
+  // credits are granted after the stream ran out of credits. The callback is
+  // released when the stream is closed, so it may hold a reference to the
+  // producer.
+  void SetWritableCallback(const base::RepeatingClosure& callback);
+
+  // Returns the number of responses that may be written now.
+  int32_t GetCredits() const;
+
+  // Returns true if the stream has ended, failed or been canceled.
+  bool IsClosed() const;
+
+ private:
+  friend class StreamQueryHandler;
+
+  // Called by StreamQueryHandler. |on_close| is run on the UI thread when the
+  // producer ends the stream.
+  QueryStream(CefRefPtr<QueryRouterBrowserSide::Callback> callback,
+              base::OnceClosure on_close);
+
+  // Called by StreamQueryHandler on the UI thread.
+  void AddCredits(int32_t credits);
+  void Cancel();
+
+  // Mark the stream closed. Returns false if it was already closed.
+  bool Close();
+
+  const CefRefPtr<QueryRouterBrowserSide::Callback> callback_;
+
+  mutable base::Lock lock_;
+  int32_t credits_;
+  bool closed_;
+  base::RepeatingClosure writable_callback_;
+  base::OnceClosure on_close_;
+
+  IMPLEMENT_REFCOUNTING(QueryStream);
+  DISALLOW_COPY_AND_ASSIGN(QueryStream);
+};
+
+// Base class for handlers whose queries are answered with a QueryStream.
+// Only persistent queries are offered to OnStreamQuery. Credits and
+// cancellation reported by the router are forwarded to the stream. Must be
+// used on the browser process UI thread.
+class StreamQueryHandler : public QueryRouterBrowserSide::Handler {
+ public:
+  StreamQueryHandler();
+  ~StreamQueryHandler() override;
+
+  // Returns the number of open streams.
+  size_t GetStreamCount() const { return streams_.size(); }
+
+  // QueryRouterBrowserSide::Handler methods.
+  bool OnQuery(CefRefPtr<CefBrowser> browser,
+               CefRefPtr<CefFrame> frame,
+               int64_t query_id,
+               const std::string& request,
+               bool persistent,
+               CefRefPtr<Callback> callback) override;
+  void OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                       CefRefPtr<CefFrame> frame,
+                       int64_t query_id) override;
+  void OnQueryCredit(CefRefPtr<CefBrowser> browser,
+                     CefRefPtr<CefFrame> frame,
+                     int64_t query_id,
+                     int32_t credits) override;
+
+ protected:
+  // Called when a persistent query is received. Return true to handle the
+  // query and write responses to |stream|, or false to offer the query to the
+  // next handler. |stream| has no credits until this method returns.
+  virtual bool OnStreamQuery(CefRefPtr<CefBrowser> browser,
+                             CefRefPtr<CefFrame> frame,
+                             const std::string& request,
+                             CefRefPtr<QueryStream> stream) = 0;
+
+ private:
+  // Map of query ID to open stream.
+  typedef std::map<int64_t, CefRefPtr<QueryStream>> StreamMap;
+
+  void OnStreamClosed(int64_t query_id);
+
+  StreamMap streams_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamQueryHandler);
+};
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_QUERY_STREAM_H_
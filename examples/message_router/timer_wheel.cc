@@ -0,0 +1,68 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/message_router/timer_wheel.h"
+
+#include <algorithm>
+
+#include "include/base/cef_logging.h"
+
+namespace message_router {
+
+TimerWheel::TimerWheel(int64_t tick_ms, size_t slot_count, int64_t now_ms)
+    : tick_ms_(tick_ms), slots_(slot_count), current_tick_(now_ms / tick_ms) {
+  DCHECK_GT(tick_ms_, 0);
+  DCHECK_GT(slot_count, 0U);
+}
+
+void TimerWheel::Schedule(int64_t id, int64_t deadline_ms) {
+  Cancel(id);
+
+  // Round up so that an ID never expires early, and never schedule into the
+  // tick that has already been processed.
+  const int64_t deadline_tick = std::max(
+      (deadline_ms + tick_ms_ - 1) / tick_ms_, current_tick_ + 1);
+  const size_t index = static_cast<size_t>(deadline_tick % slots_.size());
+
+  Slot& slot = slots_[index];
+  Entry entry = {id, deadline_tick};
+  slot.push_front(entry);
+  entries_[id] = std::make_pair(index, slot.begin());
+}
+
+bool TimerWheel::Cancel(int64_t id) {
+  EntryMap::iterator it = entries_.find(id);
+  if (it == entries_.end())
+    return false;
+  slots_[it->second.first].erase(it->second.second);
+  entries_.erase(it);
+  return true;
+}
+
+void TimerWheel::Advance(int64_t now_ms, std::vector<int64_t>& expired) {
+  const int64_t now_tick = now_ms / tick_ms_;
+  if (now_tick <= current_tick_)
+    return;
+
+  // Visit each slot at most once, even if more than one revolution passed.
+  const int64_t steps = std::min(now_tick - current_tick_,
+                                 static_cast<int64_t>(slots_.size()));
+  for (int64_t i = 1; i <= steps; ++i) {
+    Slot& slot =
+        slots_[static_cast<size_t>((current_tick_ + i) % slots_.size())];
+    Slot::iterator it = slot.begin();
+    while (it != slot.end()) {
+      if (it->deadline_tick <= now_tick) {
+        expired.push_back(it->id);
+        entries_.erase(it->id);
+        it = slot.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  current_tick_ = now_tick;
+}
+
+}  // namespace message_router
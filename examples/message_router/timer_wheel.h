@@ -0,0 +1,69 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_MESSAGE_ROUTER_TIMER_WHEEL_H_
+#define CEF_EXAMPLES_MESSAGE_ROUTER_TIMER_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "include/base/cef_macros.h"
+
+namespace message_router {
+
+// Hashed timer wheel for tracking many deadlines with constant time schedule
+// and cancel. Deadlines are rounded up to a multiple of |tick_ms| and hashed
+// into one of |slot_count| slots. Deadlines further away than one revolution
+// of the wheel share a slot with nearer deadlines and are skipped until they
+// are due. The wheel does not own a clock or a thread; the owner calls
+// Advance with the current time. Not thread safe.
+class TimerWheel {
+ public:
+  TimerWheel(int64_t tick_ms, size_t slot_count, int64_t now_ms);
+
+  // Schedule |id| to expire at |deadline_ms|. Replaces any existing deadline
+  // for |id|.
+  void Schedule(int64_t id, int64_t deadline_ms);
+
+  // Remove the deadline for |id|. Returns false if |id| was not scheduled.
+  bool Cancel(int64_t id);
+
+  // Move the wheel to |now_ms| and append the IDs whose deadline has passed
+  // to |expired|. Expired IDs are removed from the wheel.
+  void Advance(int64_t now_ms, std::vector<int64_t>& expired);
+
+  bool empty() const { return entries_.empty(); }
+  size_t size() const { return entries_.size(); }
+  int64_t tick_ms() const { return tick_ms_; }
+
+ private:
+  struct Entry {
+    int64_t id;
+    int64_t deadline_tick;
+  };
+
+  typedef std::list<Entry> Slot;
+
+  // Map of ID to slot index and position in the slot.
+  typedef std::unordered_map<int64_t, std::pair<size_t, Slot::iterator>>
+      EntryMap;
+
+  const int64_t tick_ms_;
+  std::vector<Slot> slots_;
+  EntryMap entries_;
+
+  // Last tick processed by Advance.
+  int64_t current_tick_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace message_router
+
+#endif  // CEF_EXAMPLES_MESSAGE_ROUTER_TIMER_WHEEL_H_
@@ -42,6 +42,9 @@ class BrowserApp : public CefApp, public CefBrowserProcessHandler {
 
   // CefBrowserProcessHandler methods:
   void OnContextInitialized() override {
+    // Warm the response cache while the browser and renderer processes start.
+    StartPreload(GetStartupURL());
+
     // Create the browser window.
     shared::CreateBrowser(new Client(), GetStartupURL(), CefBrowserSettings());
   }
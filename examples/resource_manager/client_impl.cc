@@ -4,18 +4,85 @@
 
 #include "examples/resource_manager/client_impl.h"
 
-#include <sstream>
-
+#include "include/cef_command_line.h"
 #include "include/wrapper/cef_helpers.h"
 #include "include/wrapper/cef_stream_resource_handler.h"
 
+#include "examples/resource_manager/resource_archive.h"
+#include "examples/resource_manager/resource_cache.h"
+#include "examples/resource_manager/resource_preloader.h"
+#include "examples/resource_manager/resource_router.h"
+#include "examples/shared/chunked_buffer.h"
+#include "examples/shared/client_manager.h"
 #include "examples/shared/client_util.h"
 #include "examples/shared/resource_util.h"
+#include "examples/shared/worker_pool.h"
+
+#if defined(OS_LINUX)
+#include "examples/shared/resource_dir_index.h"
+#endif
 
 namespace resource_manager {
 
 namespace {
 
+// Byte budget for cached responses.
+const size_t kResourceCacheSize = 64 * 1024 * 1024;
+
+#if defined(OS_LINUX)
+// Called on the resource directory watch thread when a file changes.
+void OnResourceFileChanged(ResourceCache* cache,
+                           const std::string& resource_path) {
+  cache->Invalidate(shared::kTestOrigin + resource_path);
+}
+#endif
+
+// Returns the cache shared by all Client instances. Intentionally leaked so
+// that it outlives all CefResourceManager instances.
+ResourceCache* GetResourceCache() {
+  static ResourceCache* cache = []() {
+    ResourceCache* cache = new ResourceCache(kResourceCacheSize);
+#if defined(OS_LINUX)
+    // Don't keep serving the old contents of edited files.
+    shared::ResourceDirIndex* dir_index = shared::ResourceDirIndex::Get();
+    if (dir_index) {
+      dir_index->SetChangeCallback(
+          base::BindRepeating(&OnResourceFileChanged, cache));
+    }
+#endif
+    return cache;
+  }();
+  return cache;
+}
+
+// Command-line switch that specifies a zip archive of resource files.
+const char kResourceArchive[] = "resource-archive";
+
+// Returns the archive specified via the "--resource-archive=<path>"
+// command-line switch, or nullptr if no valid archive was specified. The
+// archive is opened on first use and its compressed entries are inflated on a
+// worker thread, or on the CEF blocking file thread if the first use is
+// before the worker pool exists. Intentionally leaked so that it outlives all
+// CefResourceManager instances.
+ResourceArchive* GetResourceArchive() {
+  static ResourceArchive* archive = []() -> ResourceArchive* {
+    const std::string& path =
+        CefCommandLine::GetGlobalCommandLine()->GetSwitchValue(
+            kResourceArchive);
+    if (path.empty())
+      return nullptr;
+
+    ResourceArchive* archive = ResourceArchive::Open(path).release();
+    if (archive) {
+      // Requests for entries that are not inflated yet inflate them on demand.
+      shared::WorkerPool::PostBlockingTask(base::BindOnce(
+          &ResourceArchive::InflateAll, base::Unretained(archive)));
+    }
+    return archive;
+  }();
+  return archive;
+}
+
 // Demonstrate a custom Provider implementation by dumping the request contents.
 class RequestDumpResourceProvider : public CefResourceManager::Provider {
  public:
@@ -32,13 +99,20 @@ class RequestDumpResourceProvider : public CefResourceManager::Provider {
       return false;
     }
 
-    const std::string& dump = shared::DumpRequestContents(request->request());
-    std::string str =
-        "<html><body bgcolor=\"white\"><pre>" + dump + "</pre></body></html>";
-    CefRefPtr<CefStreamReader> stream = CefStreamReader::CreateForData(
-        static_cast<void*>(const_cast<char*>(str.c_str())), str.size());
+    // Write the response directly into a chunked buffer that is then streamed
+    // without copying.
+    CefRefPtr<shared::ChunkedBuffer> buffer = new shared::ChunkedBuffer();
+    buffer->Append("<html><body bgcolor=\"white\"><pre>");
+    shared::DumpRequestContents(request->request(), *buffer);
+    buffer->Append("</pre></body></html>");
+    CefRefPtr<CefStreamReader> stream = buffer->CreateReader();
     DCHECK(stream.get());
-    request->Continue(new CefStreamResourceHandler("text/html", stream));
+
+    // The contents are different for every request.
+    CefResponse::HeaderMap header_map;
+    header_map.insert(std::make_pair("Cache-Control", "no-store"));
+    request->Continue(new CefStreamResourceHandler(200, "OK", "text/html",
+                                                   header_map, stream));
     return true;
   }
 
@@ -56,30 +130,54 @@ void SetupResourceManager(CefRefPtr<CefResourceManager> resource_manager) {
     return;
   }
 
+  // Resolve mime types from the shared table and memo instead of calling into
+  // the CEF library for every request.
+  resource_manager->SetMimeTypeResolver(
+      base::BindRepeating(&shared::GetMimeTypeForUrl));
+
   const std::string& test_origin = shared::kTestOrigin;
 
-  // Add the Provider for dumping request contents.
-  resource_manager->AddProvider(
-      new RequestDumpResourceProvider(test_origin + "request.html"), 0,
-      std::string());
-
-// Add the Provider for bundled resource files.
-#if defined(OS_WIN)
-  // Read BINARY resources from the executable.
-  resource_manager->AddProvider(
-      shared::CreateBinaryResourceProvider(test_origin), 100, std::string());
-#elif defined(OS_POSIX)
-  // Read individual resource files from a directory on disk.
-  std::string resource_dir;
-  if (shared::GetResourceDir(resource_dir)) {
-    resource_manager->AddDirectoryProvider(test_origin, resource_dir, 100,
-                                           std::string());
+  // Add the Provider for cached responses. It must run before the Providers
+  // whose responses are cached.
+  resource_manager->AddProvider(GetResourceCache()->CreateProvider(), 0,
+                                std::string());
+
+  // Add the remaining Providers to a router so that each request is matched
+  // against all routes with a single lookup.
+  ResourceRouter* router = new ResourceRouter();
+
+  // Route for dumping request contents.
+  router->AddExactRoute(
+      test_origin + "request.html",
+      new RequestDumpResourceProvider(test_origin + "request.html"));
+
+  // Route for the resource archive, if any. Its contents take precedence over
+  // the bundled resource files.
+  ResourceArchive* archive = GetResourceArchive();
+  if (archive) {
+    router->AddPrefixRoute(test_origin, archive->CreateProvider(test_origin));
   }
-#endif
+
+  // Route for bundled resource files.
+  router->AddPrefixRoute(test_origin,
+                         shared::CreateResourceProvider(test_origin));
+
+  resource_manager->AddProvider(router, 100, std::string());
 }
 
 }  // namespace
 
+void StartPreload(const std::string& url) {
+  if (GetResourceArchive()) {
+    // Responses are preloaded from the resource index which the archive
+    // overrides.
+    return;
+  }
+
+  shared::WorkerPool::PostBlockingTask(
+      base::BindOnce(&PreloadResources, GetResourceCache(), url));
+}
+
 Client::Client() {
   resource_manager_ = new CefResourceManager();
   SetupResourceManager(resource_manager_);
@@ -103,7 +201,17 @@ bool Client::DoClose(CefRefPtr<CefBrowser> browser) {
 
 void Client::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
   // Call the default shared implementation.
-  return shared::OnBeforeClose(browser);
+  shared::OnBeforeClose(browser);
+
+  // The cache is shared by all browsers so only log its cumulative counters
+  // once, when the last browser has closed.
+  if (shared::ClientManager::GetInstance()->GetBrowserCount() == 0) {
+    const ResourceCache::Stats& stats = GetResourceCache()->GetStats();
+    LOG(INFO) << "Resource cache: hits=" << stats.hits
+              << " misses=" << stats.misses << " coalesced=" << stats.coalesced
+              << " insertions=" << stats.insertions
+              << " evictions=" << stats.evictions << " size=" << stats.size;
+  }
 }
 
 CefRefPtr<CefResourceRequestHandler> Client::GetResourceRequestHandler(
@@ -135,7 +243,9 @@ CefRefPtr<CefResourceHandler> Client::GetResourceHandler(
     CefRefPtr<CefRequest> request) {
   CEF_REQUIRE_IO_THREAD();
 
-  return resource_manager_->GetResourceHandler(browser, frame, request);
+  // Cache the responses of other Providers.
+  return GetResourceCache()->WrapHandler(
+      request, resource_manager_->GetResourceHandler(browser, frame, request));
 }
 
 }  // namespace resource_manager
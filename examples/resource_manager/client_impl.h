@@ -10,6 +10,12 @@
 
 namespace resource_manager {
 
+// Start loading the responses for |url| and the resources that it references
+// into the response cache on a worker thread, so that they are ready when the
+// browser requests them. Called from OnContextInitialized, before the worker
+// pool exists, in which case the CEF blocking file thread is used instead.
+void StartPreload(const std::string& url);
+
 // Implementation of client handlers.
 class Client : public CefClient,
                public CefDisplayHandler,
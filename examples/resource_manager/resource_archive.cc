@@ -0,0 +1,423 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/resource_manager/resource_archive.h"
+
+#include <stdio.h>
+
+#if defined(OS_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "include/base/cef_bind.h"
+#include "include/cef_zip_reader.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/wrapper/cef_stream_resource_handler.h"
+
+#include "examples/shared/chunked_buffer.h"
+#include "examples/shared/resource_util.h"
+#include "examples/shared/worker_pool.h"
+
+namespace resource_manager {
+
+namespace {
+
+// Record signatures and fixed sizes from the zip file format specification.
+const uint32_t kEndOfCentralDirSignature = 0x06054b50;
+const uint32_t kCentralDirSignature = 0x02014b50;
+const uint32_t kLocalHeaderSignature = 0x04034b50;
+const size_t kEndOfCentralDirSize = 22;
+const size_t kCentralDirHeaderSize = 46;
+const size_t kLocalHeaderSize = 30;
+const size_t kMaxCommentSize = 0xffff;
+
+// Compression methods.
+const uint16_t kMethodStored = 0;
+const uint16_t kMethodDeflated = 8;
+
+// General purpose flag for encrypted entries.
+const uint16_t kFlagEncrypted = 0x1;
+
+uint16_t ReadUInt16(const unsigned char* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadUInt32(const unsigned char* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Map the file at |path| into memory. Returns false on failure.
+bool MapFile(const std::string& path,
+             const unsigned char** out_base,
+             size_t* out_size) {
+#if defined(OS_WIN)
+  HANDLE file = ::CreateFileW(CefString(path).ToWString().c_str(),
+                              GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0 ||
+      static_cast<uint64_t>(size.QuadPart) > SIZE_MAX) {
+    ::CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping =
+      ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  ::CloseHandle(file);
+  if (!mapping)
+    return false;
+
+  // The view remains valid after the mapping handle is closed.
+  void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  ::CloseHandle(mapping);
+  if (!data)
+    return false;
+
+  *out_base = static_cast<const unsigned char*>(data);
+  *out_size = static_cast<size_t>(size.QuadPart);
+  return true;
+#else
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping remains valid after the descriptor is closed.
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+
+  *out_base = static_cast<const unsigned char*>(data);
+  *out_size = size;
+  return true;
+#endif
+}
+
+void UnmapFile(const unsigned char* base, size_t size) {
+#if defined(OS_WIN)
+  ::UnmapViewOfFile(base);
+#else
+  munmap(const_cast<unsigned char*>(base), size);
+#endif
+}
+
+// Read the current file of |reader| into |out|. Returns false if the file
+// cannot be inflated or the size doesn't match the central directory.
+bool InflateCurrentFile(CefRefPtr<CefZipReader> reader,
+                        const ResourceArchive::Entry& entry,
+                        std::string& out) {
+  if (!reader->OpenFile(CefString()))
+    return false;
+
+  out.resize(entry.size);
+  size_t offset = 0;
+  while (offset < out.size()) {
+    const int result = reader->ReadFile(&out[offset], out.size() - offset);
+    if (result <= 0)
+      break;
+    offset += static_cast<size_t>(result);
+  }
+  reader->CloseFile();
+
+  return offset == entry.size;
+}
+
+// Returns a handler for a 200 response with |reader| as the body, or for an
+// empty 304 response if |reader| is nullptr.
+CefRefPtr<CefResourceHandler> CreateHandler(
+    const ResourceArchive::Entry& entry,
+    const std::string& mime_type,
+    CefRefPtr<CefStreamReader> reader) {
+  // Archive contents don't change while the application is running.
+  CefResponse::HeaderMap header_map;
+  header_map.insert(std::make_pair("ETag", entry.etag));
+  header_map.insert(
+      std::make_pair("Cache-Control", shared::kResourceCacheControl));
+
+  if (!reader) {
+    return new CefStreamResourceHandler(304, "Not Modified", mime_type,
+                                        header_map, nullptr);
+  }
+  return new CefStreamResourceHandler(200, "OK", mime_type, header_map,
+                                      reader);
+}
+
+// Inflate |name| and continue |request|. Runs on a worker thread.
+void InflateAndContinue(ResourceArchive* archive,
+                        const std::string& name,
+                        const ResourceArchive::Entry* entry,
+                        const std::string& mime_type,
+                        scoped_refptr<CefResourceManager::Request> request) {
+  CefRefPtr<CefStreamReader> reader =
+      archive->CreateReader(name, *entry, true);
+  request->Continue(reader ? CreateHandler(*entry, mime_type, reader)
+                           : nullptr);
+}
+
+// Provider implementation for loading resources from a ResourceArchive.
+class ArchiveProvider : public CefResourceManager::Provider {
+ public:
+  ArchiveProvider(ResourceArchive* archive, const std::string& root_url)
+      : archive_(archive), root_url_(root_url) {
+    DCHECK(archive);
+    DCHECK(!root_url.empty());
+  }
+
+  bool OnRequest(scoped_refptr<CefResourceManager::Request> request) override {
+    CEF_REQUIRE_IO_THREAD();
+
+    const std::string& url = request->url();
+    const std::string& name = shared::GetResourcePath(url, root_url_);
+    const ResourceArchive::Entry* entry =
+        name.empty() ? nullptr : archive_->FindEntry(name);
+    if (!entry) {
+      // Not handled by this provider.
+      return false;
+    }
+
+    const std::string& mime_type = request->mime_type_resolver().Run(url);
+
+    if (shared::MatchesETag(request->request(), entry->etag)) {
+      // The client already has this version.
+      request->Continue(CreateHandler(*entry, mime_type, nullptr));
+      return true;
+    }
+
+    // Stored and already inflated entries are read from memory.
+    CefRefPtr<CefStreamReader> reader =
+        archive_->CreateReader(name, *entry, false);
+    if (reader) {
+      request->Continue(CreateHandler(*entry, mime_type, reader));
+      return true;
+    }
+
+    // Inflate the entry without blocking the IO thread.
+    if (!shared::WorkerPool::PostTask(
+            base::BindOnce(&InflateAndContinue, base::Unretained(archive_),
+                           name, base::Unretained(entry), mime_type,
+                           request))) {
+      InflateAndContinue(archive_, name, entry, mime_type, request);
+    }
+    return true;
+  }
+
+ private:
+  ResourceArchive* const archive_;
+  const std::string root_url_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveProvider);
+};
+
+}  // namespace
+
+ResourceArchive::ResourceArchive(const unsigned char* base, size_t size)
+    : base_(base), size_(size) {}
+
+ResourceArchive::~ResourceArchive() {
+  UnmapFile(base_, size_);
+}
+
+// static
+std::unique_ptr<ResourceArchive> ResourceArchive::Open(
+    const std::string& path) {
+  const unsigned char* base;
+  size_t size;
+  if (!MapFile(path, &base, &size))
+    return nullptr;
+
+  std::unique_ptr<ResourceArchive> archive(new ResourceArchive(base, size));
+  if (!archive->BuildIndex()) {
+    LOG(ERROR) << "Invalid resource archive " << path;
+    return nullptr;
+  }
+  return archive;
+}
+
+const ResourceArchive::Entry* ResourceArchive::FindEntry(
+    const std::string& name) const {
+  std::unordered_map<std::string, Entry>::const_iterator it =
+      entries_.find(name);
+  if (it == entries_.end())
+    return nullptr;
+  return &it->second;
+}
+
+CefRefPtr<CefStreamReader> ResourceArchive::CreateReader(
+    const std::string& name,
+    const Entry& entry,
+    bool may_block) {
+  const unsigned char* data = entry.data;
+  if (entry.deflated) {
+    const std::string* contents = FindInflated(name);
+    if (!contents) {
+      if (!may_block)
+        return nullptr;
+
+      // CefZipReader must be used on a single thread so create one for this
+      // call. The archive's central directory is already mapped so this is
+      // inexpensive compared to inflating.
+      CefRefPtr<CefZipReader> reader = CefZipReader::Create(
+          shared::CreateMemoryReader(base_, size_, nullptr));
+      std::string inflated;
+      if (!reader || !reader->MoveToFile(name, true) ||
+          !InflateCurrentFile(reader, entry, inflated)) {
+        LOG(ERROR) << "Failed to inflate resource archive entry " << name;
+        return nullptr;
+      }
+      contents = AddInflated(name, std::move(inflated));
+    }
+    data = reinterpret_cast<const unsigned char*>(contents->data());
+  }
+
+  // Read directly from the mapping or the cache.
+  return shared::CreateMemoryReader(data, entry.size, nullptr);
+}
+
+void ResourceArchive::InflateAll() {
+  CefRefPtr<CefZipReader> reader =
+      CefZipReader::Create(shared::CreateMemoryReader(base_, size_, nullptr));
+  if (!reader || !reader->MoveToFirstFile())
+    return;
+
+  // Visit files in archive order so that each is located without a search.
+  do {
+    const std::string& name = reader->GetFileName();
+    const Entry* entry = FindEntry(name);
+    if (!entry || !entry->deflated || FindInflated(name))
+      continue;
+
+    std::string inflated;
+    if (InflateCurrentFile(reader, *entry, inflated))
+      AddInflated(name, std::move(inflated));
+    else
+      LOG(ERROR) << "Failed to inflate resource archive entry " << name;
+  } while (reader->MoveToNextFile());
+
+  reader->Close();
+}
+
+CefResourceManager::Provider* ResourceArchive::CreateProvider(
+    const std::string& root_url) {
+  return new ArchiveProvider(this, root_url);
+}
+
+bool ResourceArchive::BuildIndex() {
+  if (size_ < kEndOfCentralDirSize)
+    return false;
+
+  // The end of central directory record is followed by a variable length
+  // comment, so search backwards for its signature.
+  const unsigned char* eocd = nullptr;
+  const size_t search_start = size_ - kEndOfCentralDirSize;
+  const size_t search_end =
+      search_start > kMaxCommentSize ? search_start - kMaxCommentSize : 0;
+  for (size_t pos = search_start + 1; pos-- > search_end;) {
+    if (ReadUInt32(base_ + pos) == kEndOfCentralDirSignature) {
+      eocd = base_ + pos;
+      break;
+    }
+  }
+  if (!eocd)
+    return false;
+
+  const size_t count = ReadUInt16(eocd + 10);
+  const size_t dir_size = ReadUInt32(eocd + 12);
+  const size_t dir_offset = ReadUInt32(eocd + 16);
+  if (dir_offset > size_ || dir_size > size_ - dir_offset)
+    return false;
+
+  entries_.reserve(count);
+
+  const unsigned char* p = base_ + dir_offset;
+  const unsigned char* const dir_end = p + dir_size;
+  for (size_t i = 0; i < count; ++i) {
+    if (static_cast<size_t>(dir_end - p) < kCentralDirHeaderSize ||
+        ReadUInt32(p) != kCentralDirSignature) {
+      return false;
+    }
+
+    const uint16_t flags = ReadUInt16(p + 8);
+    const uint16_t method = ReadUInt16(p + 10);
+    const uint32_t crc = ReadUInt32(p + 16);
+    const size_t compressed_size = ReadUInt32(p + 20);
+    const size_t size = ReadUInt32(p + 24);
+    const size_t name_length = ReadUInt16(p + 28);
+    const size_t record_size = kCentralDirHeaderSize + name_length +
+                               ReadUInt16(p + 30) + ReadUInt16(p + 32);
+    const size_t local_offset = ReadUInt32(p + 42);
+    if (static_cast<size_t>(dir_end - p) < record_size)
+      return false;
+
+    const std::string name(reinterpret_cast<const char*>(p) +
+                               kCentralDirHeaderSize,
+                           name_length);
+    p += record_size;
+
+    // ZIP64 entries store 0xffffffff and the real values in an extra field.
+    if ((flags & kFlagEncrypted) ||
+        (method != kMethodStored && method != kMethodDeflated) ||
+        compressed_size == 0xffffffff || size == 0xffffffff ||
+        local_offset == 0xffffffff || name.empty() ||
+        name[name.length() - 1] == '/') {
+      continue;
+    }
+    if (method == kMethodStored && compressed_size != size)
+      continue;
+
+    // The local header repeats the name and has its own extra field.
+    if (local_offset > size_ || size_ - local_offset < kLocalHeaderSize)
+      continue;
+    const unsigned char* local = base_ + local_offset;
+    if (ReadUInt32(local) != kLocalHeaderSignature)
+      continue;
+    const size_t data_offset = local_offset + kLocalHeaderSize +
+                               ReadUInt16(local + 26) + ReadUInt16(local + 28);
+    if (data_offset > size_ || size_ - data_offset < compressed_size)
+      continue;
+
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"z%08x-%zx\"", crc, size);
+
+    Entry entry = {base_ + data_offset, compressed_size, size,
+                   method == kMethodDeflated, etag};
+    entries_.insert(std::make_pair(name, std::move(entry)));
+  }
+
+  return true;
+}
+
+const std::string* ResourceArchive::FindInflated(const std::string& name) {
+  base::AutoLock lock_scope(lock_);
+  std::map<std::string, std::string>::const_iterator it = inflated_.find(name);
+  if (it == inflated_.end())
+    return nullptr;
+  return &it->second;
+}
+
+const std::string* ResourceArchive::AddInflated(const std::string& name,
+                                                std::string contents) {
+  base::AutoLock lock_scope(lock_);
+  return &inflated_.insert(std::make_pair(name, std::move(contents)))
+              .first->second;
+}
+
+}  // namespace resource_manager
@@ -0,0 +1,102 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_ARCHIVE_H_
+#define CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_ARCHIVE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "include/base/cef_lock.h"
+#include "include/cef_stream.h"
+#include "include/wrapper/cef_resource_manager.h"
+
+namespace resource_manager {
+
+// Zip archive of resource files that is mapped into memory and indexed once.
+// Unlike the archive Provider created by CefResourceManager::AddArchiveProvider
+// lookups use a hash index of the central directory without locking, stored
+// entries are read directly from the mapping, and deflated entries are
+// inflated at most once into a cache that is shared by all requests. Methods
+// may be called on any thread. The archive must outlive any Providers and
+// stream readers created from it.
+class ResourceArchive {
+ public:
+  // Central directory entry for a single file.
+  struct Entry {
+    // Start of the file data in the mapping. Compressed if |deflated| is true.
+    const unsigned char* data;
+    size_t compressed_size;
+    // Uncompressed size.
+    size_t size;
+    bool deflated;
+    // Strong ETag value derived from the CRC-32 and size.
+    std::string etag;
+  };
+
+  ~ResourceArchive();
+
+  // Map and index the archive at |path|. Returns nullptr if the file cannot be
+  // mapped or is not a valid zip archive. Entries that are encrypted, use
+  // ZIP64 extensions or a compression method other than deflate are ignored.
+  static std::unique_ptr<ResourceArchive> Open(const std::string& path);
+
+  // Returns the entry for |name|, or nullptr if the archive does not contain
+  // the file.
+  const Entry* FindEntry(const std::string& name) const;
+
+  // Returns a reader for the uncompressed contents of |name|. If the entry is
+  // deflated and not yet cached then it will be inflated if |may_block| is
+  // true, otherwise nullptr is returned. Also returns nullptr on failure.
+  CefRefPtr<CefStreamReader> CreateReader(const std::string& name,
+                                          const Entry& entry,
+                                          bool may_block);
+
+  // Inflate all deflated entries into the cache. Blocks until complete so it
+  // should be called on a worker thread.
+  void InflateAll();
+
+  // Returns a Provider that serves archive entries for URLs that start with
+  // |root_url|. Requests for files that are not in the archive are passed to
+  // the next Provider.
+  CefResourceManager::Provider* CreateProvider(const std::string& root_url);
+
+ private:
+  ResourceArchive(const unsigned char* base, size_t size);
+
+  // Parse the central directory. Returns false if the archive is invalid.
+  bool BuildIndex();
+
+  // Returns the cached contents of |name|, or nullptr.
+  const std::string* FindInflated(const std::string& name);
+
+  // Add |contents| for |name| to the cache. Returns the cached contents, which
+  // may be from a concurrent call that finished first.
+  const std::string* AddInflated(const std::string& name,
+                                 std::string contents);
+
+  // Start and size of the mapping.
+  const unsigned char* const base_;
+  const size_t size_;
+
+  // Immutable after BuildIndex() so lookups don't lock.
+  std::unordered_map<std::string, Entry> entries_;
+
+  base::Lock lock_;
+
+  // Inflated contents keyed by entry name. Entries are never removed so the
+  // string data remains valid for the lifespan of this object.
+  std::map<std::string, std::string> inflated_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceArchive);
+};
+
+}  // namespace resource_manager
+
+#endif  // CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_ARCHIVE_H_
@@ -0,0 +1,536 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/resource_manager/resource_cache.h"
+
+#include <ctype.h>
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "include/base/cef_lock.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/wrapper/cef_stream_resource_handler.h"
+
+#include "examples/shared/chunked_buffer.h"
+#include "examples/shared/resource_util.h"
+
+namespace resource_manager {
+
+namespace {
+
+// Number of independently locked shards.
+const size_t kShardCount = 8;
+
+// Returns true if |a| and |b| are equal ignoring ASCII case.
+bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+  if (a.length() != b.length())
+    return false;
+  for (size_t i = 0; i < a.length(); ++i) {
+    if (tolower(static_cast<unsigned char>(a[i])) !=
+        tolower(static_cast<unsigned char>(b[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the value of the first |name| header in |header_map|.
+std::string GetHeader(const CefResponse::HeaderMap& header_map,
+                      const std::string& name) {
+  CefResponse::HeaderMap::const_iterator it = header_map.begin();
+  for (; it != header_map.end(); ++it) {
+    if (EqualsIgnoreCase(it->first, name))
+      return it->second;
+  }
+  return std::string();
+}
+
+}  // namespace
+
+class ResourceCache::Response : public CefBaseRefCounted {
+ public:
+  Response(int status,
+           const std::string& status_text,
+           const std::string& mime_type,
+           const CefResponse::HeaderMap& header_map,
+           CefRefPtr<shared::ChunkedBuffer> body)
+      : status_(status),
+        status_text_(status_text),
+        mime_type_(mime_type),
+        header_map_(header_map),
+        etag_(GetHeader(header_map, "ETag")),
+        body_(body) {}
+
+  int status() const { return status_; }
+  const std::string& status_text() const { return status_text_; }
+  const std::string& mime_type() const { return mime_type_; }
+  const CefResponse::HeaderMap& header_map() const { return header_map_; }
+  const std::string& etag() const { return etag_; }
+  CefRefPtr<shared::ChunkedBuffer> body() const { return body_; }
+
+  // Approximate memory usage counted against the cache budget.
+  size_t size() const { return body_->size() + 256 * header_map_.size(); }
+
+ private:
+  const int status_;
+  const std::string status_text_;
+  const std::string mime_type_;
+  const CefResponse::HeaderMap header_map_;
+  const std::string etag_;
+  const CefRefPtr<shared::ChunkedBuffer> body_;
+
+  IMPLEMENT_REFCOUNTING(Response);
+  DISALLOW_COPY_AND_ASSIGN(Response);
+};
+
+// Independently locked part of the cache. The |lru_| list is ordered from most
+// to least recently used. |loading_| maps the keys of responses that are being
+// loaded to the requests that are waiting for them.
+class ResourceCache::Shard {
+ public:
+  Shard() : size_(0) {}
+
+  base::Lock lock_;
+
+  typedef std::list<std::pair<std::string, CefRefPtr<Response>>> EntryList;
+  EntryList lru_;
+  std::unordered_map<std::string, EntryList::iterator> entries_;
+  size_t size_;
+
+  typedef std::vector<scoped_refptr<CefResourceManager::Request>> RequestList;
+  std::unordered_map<std::string, RequestList> loading_;
+};
+
+namespace {
+
+// Provider implementation that serves responses from the cache and holds
+// requests for responses that are being loaded.
+class CachingProvider : public CefResourceManager::Provider {
+ public:
+  explicit CachingProvider(ResourceCache* cache) : cache_(cache) {}
+
+  bool OnRequest(scoped_refptr<CefResourceManager::Request> request) override {
+    CEF_REQUIRE_IO_THREAD();
+
+    const std::string& key = ResourceCache::GetKey(request->request());
+    if (key.empty())
+      return false;
+
+    // Returns false if not handled by this provider.
+    return cache_->FindOrWait(key, request);
+  }
+
+ private:
+  ResourceCache* const cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(CachingProvider);
+};
+
+// Resource handler that forwards to another handler and copies a successful
+// response into the cache as it is read. Owns the load started with
+// ResourceCache::BeginLoad() for |key| and ends it exactly once.
+class CachingResourceHandler : public CefResourceHandler {
+ public:
+  CachingResourceHandler(ResourceCache* cache,
+                         const std::string& key,
+                         CefRefPtr<CefResourceHandler> handler)
+      : cache_(cache),
+        key_(key),
+        handler_(handler),
+        loading_(true),
+        canceled_(false),
+        status_(0) {}
+
+  ~CachingResourceHandler() override {
+    // Release waiting requests if the response was never completed.
+    EndLoad(nullptr);
+  }
+
+  bool Open(CefRefPtr<CefRequest> request,
+            bool& handle_request,
+            CefRefPtr<CefCallback> callback) override {
+    return handler_->Open(request, handle_request, callback);
+  }
+
+  bool ProcessRequest(CefRefPtr<CefRequest> request,
+                      CefRefPtr<CefCallback> callback) override {
+    return handler_->ProcessRequest(request, callback);
+  }
+
+  void GetResponseHeaders(CefRefPtr<CefResponse> response,
+                          int64_t& response_length,
+                          CefString& redirectUrl) override {
+    handler_->GetResponseHeaders(response, response_length, redirectUrl);
+
+    // Only cache complete successful responses. Waiting requests load their
+    // own response otherwise.
+    status_ = response->GetStatus();
+    if (status_ != 200 || !redirectUrl.empty()) {
+      EndLoad(nullptr);
+      return;
+    }
+
+    response->GetHeaderMap(header_map_);
+    if (GetHeader(header_map_, "Cache-Control").find("no-store") !=
+        std::string::npos) {
+      EndLoad(nullptr);
+      return;
+    }
+
+    status_text_ = response->GetStatusText();
+    mime_type_ = response->GetMimeType();
+    body_ = new shared::ChunkedBuffer();
+  }
+
+  bool Skip(int64_t bytes_to_skip,
+            int64_t& bytes_skipped,
+            CefRefPtr<CefResourceSkipCallback> callback) override {
+    // The body will be incomplete.
+    body_ = nullptr;
+    EndLoad(nullptr);
+    return handler_->Skip(bytes_to_skip, bytes_skipped, callback);
+  }
+
+  bool Read(void* data_out,
+            int bytes_to_read,
+            int& bytes_read,
+            CefRefPtr<CefResourceReadCallback> callback) override {
+    CefRefPtr<CefResourceReadCallback> read_callback = callback;
+    if (body_)
+      read_callback = new ReadCallback(this, data_out, callback);
+
+    const bool result =
+        handler_->Read(data_out, bytes_to_read, bytes_read, read_callback);
+    if (result) {
+      if (bytes_read > 0)
+        OnDataRead(data_out, bytes_read);
+    } else {
+      OnReadComplete(bytes_read);
+    }
+    return result;
+  }
+
+  bool ReadResponse(void* data_out,
+                    int bytes_to_read,
+                    int& bytes_read,
+                    CefRefPtr<CefCallback> callback) override {
+    const bool result =
+        handler_->ReadResponse(data_out, bytes_to_read, bytes_read, callback);
+    if (result) {
+      if (bytes_read > 0)
+        OnDataRead(data_out, bytes_read);
+    } else {
+      OnReadComplete(bytes_read);
+    }
+    return result;
+  }
+
+  void Cancel() override {
+    // Called on the IO thread while a read may be in progress on another
+    // thread, so leave |body_| to the reading thread.
+    canceled_ = true;
+    EndLoad(nullptr);
+    handler_->Cancel();
+  }
+
+ private:
+  // Intercepts asynchronous read completion.
+  class ReadCallback : public CefResourceReadCallback {
+   public:
+    ReadCallback(CefRefPtr<CachingResourceHandler> handler,
+                 void* data_out,
+                 CefRefPtr<CefResourceReadCallback> callback)
+        : handler_(handler), data_out_(data_out), callback_(callback) {}
+
+    void Continue(int bytes_read) override {
+      if (bytes_read > 0)
+        handler_->OnDataRead(data_out_, bytes_read);
+      else
+        handler_->OnReadComplete(bytes_read);
+      callback_->Continue(bytes_read);
+    }
+
+   private:
+    const CefRefPtr<CachingResourceHandler> handler_;
+    void* const data_out_;
+    const CefRefPtr<CefResourceReadCallback> callback_;
+
+    IMPLEMENT_REFCOUNTING(ReadCallback);
+    DISALLOW_COPY_AND_ASSIGN(ReadCallback);
+  };
+
+  void OnDataRead(const void* data, int size) {
+    if (canceled_)
+      body_ = nullptr;
+    else if (body_)
+      body_->Append(static_cast<const char*>(data), size);
+  }
+
+  // |result| is 0 on success or an error code on failure.
+  void OnReadComplete(int result) {
+    CefRefPtr<ResourceCache::Response> response;
+    if (body_ && result == 0 && !canceled_) {
+      response = new ResourceCache::Response(status_, status_text_, mime_type_,
+                                             header_map_, body_);
+      cache_->Insert(key_, response);
+    }
+    body_ = nullptr;
+    EndLoad(response);
+  }
+
+  // Pass |response| to waiting requests. Only the first call has an effect.
+  void EndLoad(CefRefPtr<ResourceCache::Response> response) {
+    if (loading_.exchange(false))
+      cache_->EndLoad(key_, response);
+  }
+
+  ResourceCache* const cache_;
+  const std::string key_;
+  const CefRefPtr<CefResourceHandler> handler_;
+
+  // True until the load has ended. Cancel() may race with completion.
+  std::atomic<bool> loading_;
+
+  // Set by Cancel(). The response is then not cached.
+  std::atomic<bool> canceled_;
+
+  // Response being captured. |body_| is nullptr if the response will not be
+  // cached. Only accessed on the thread that reads the response.
+  int status_;
+  std::string status_text_;
+  std::string mime_type_;
+  CefResponse::HeaderMap header_map_;
+  CefRefPtr<shared::ChunkedBuffer> body_;
+
+  IMPLEMENT_REFCOUNTING(CachingResourceHandler);
+  DISALLOW_COPY_AND_ASSIGN(CachingResourceHandler);
+};
+
+}  // namespace
+
+ResourceCache::ResourceCache(size_t byte_budget)
+    : shard_budget_(byte_budget / kShardCount),
+      shards_(new Shard[kShardCount]),
+      hits_(0),
+      misses_(0),
+      coalesced_(0),
+      insertions_(0),
+      evictions_(0) {}
+
+ResourceCache::~ResourceCache() {}
+
+CefResourceManager::Provider* ResourceCache::CreateProvider() {
+  return new CachingProvider(this);
+}
+
+CefRefPtr<CefResourceHandler> ResourceCache::WrapHandler(
+    CefRefPtr<CefRequest> request,
+    CefRefPtr<CefResourceHandler> handler) {
+  const std::string& key = GetKey(request);
+  if (!handler || key.empty() || !BeginLoad(key)) {
+    // Not cacheable, already served from the cache or being loaded by another
+    // request.
+    return handler;
+  }
+  return new CachingResourceHandler(this, key, handler);
+}
+
+ResourceCache::Stats ResourceCache::GetStats() const {
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.coalesced = coalesced_;
+  stats.insertions = insertions_;
+  stats.evictions = evictions_;
+  stats.size = 0;
+  for (size_t i = 0; i < kShardCount; ++i) {
+    base::AutoLock lock_scope(shards_[i].lock_);
+    stats.size += shards_[i].size_;
+  }
+  return stats;
+}
+
+void ResourceCache::Invalidate(const std::string& url) {
+  const size_t length = url.length();
+  for (size_t i = 0; i < kShardCount; ++i) {
+    Shard& shard = shards_[i];
+    base::AutoLock lock_scope(shard.lock_);
+
+    Shard::EntryList::iterator it = shard.lru_.begin();
+    while (it != shard.lru_.end()) {
+      const std::string& key = it->first;
+      if (key.length() > length && key.compare(0, length, url) == 0 &&
+          (key[length] == '\n' || key[length] == '?')) {
+        shard.size_ -= it->second->size();
+        shard.entries_.erase(key);
+        it = shard.lru_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+// static
+std::string ResourceCache::GetKey(CefRefPtr<CefRequest> request) {
+  // Only cache simple GET requests for complete resources.
+  if (request->GetMethod() != "GET" || request->GetPostData() ||
+      !request->GetHeaderByName("Range").empty()) {
+    return std::string();
+  }
+
+  // Normalize the URL by removing the fragment and converting the scheme and
+  // host to lowercase.
+  std::string key = request->GetURL();
+  const size_t fragment = key.find('#');
+  if (fragment != std::string::npos)
+    key.resize(fragment);
+  const size_t scheme_end = key.find("://");
+  if (scheme_end != std::string::npos) {
+    const size_t host_end = key.find('/', scheme_end + 3);
+    const size_t end = host_end == std::string::npos ? key.length() : host_end;
+    for (size_t i = 0; i < end; ++i)
+      key[i] = static_cast<char>(tolower(static_cast<unsigned char>(key[i])));
+  }
+
+  // Responses may vary based on the accepted encodings. Only gzip is served
+  // by the Providers in this example so that's the only distinction made.
+  key.append(shared::AcceptsEncoding(request, "gzip") ? "\ngzip" : "\n");
+  return key;
+}
+
+ResourceCache::Shard& ResourceCache::GetShard(const std::string& key) {
+  return shards_[std::hash<std::string>()(key) % kShardCount];
+}
+
+bool ResourceCache::FindOrWait(
+    const std::string& key,
+    scoped_refptr<CefResourceManager::Request> request) {
+  CefRefPtr<Response> response;
+  {
+    Shard& shard = GetShard(key);
+    base::AutoLock lock_scope(shard.lock_);
+
+    auto it = shard.entries_.find(key);
+    if (it != shard.entries_.end()) {
+      // Move to the front of the usage list.
+      shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+      ++hits_;
+      response = it->second->second;
+    } else {
+      auto loading = shard.loading_.find(key);
+      if (loading == shard.loading_.end()) {
+        ++misses_;
+        return false;
+      }
+
+      // Continued from EndLoad().
+      loading->second.push_back(request);
+      ++coalesced_;
+      return true;
+    }
+  }
+
+  request->Continue(CreateHandler(response, request->request()));
+  return true;
+}
+
+void ResourceCache::Insert(const std::string& key,
+                           CefRefPtr<Response> response) {
+  const size_t size = response->size();
+  if (size > shard_budget_)
+    return;
+
+  Shard& shard = GetShard(key);
+  base::AutoLock lock_scope(shard.lock_);
+
+  if (shard.entries_.find(key) != shard.entries_.end()) {
+    // Another request added the same response first.
+    return;
+  }
+
+  // Evict the least recently used responses until the new response fits.
+  while (shard.size_ + size > shard_budget_) {
+    DCHECK(!shard.lru_.empty());
+    shard.size_ -= shard.lru_.back().second->size();
+    shard.entries_.erase(shard.lru_.back().first);
+    shard.lru_.pop_back();
+    ++evictions_;
+  }
+
+  shard.lru_.push_front(std::make_pair(key, response));
+  shard.entries_.insert(std::make_pair(key, shard.lru_.begin()));
+  shard.size_ += size;
+  ++insertions_;
+}
+
+bool ResourceCache::BeginLoad(const std::string& key) {
+  Shard& shard = GetShard(key);
+  base::AutoLock lock_scope(shard.lock_);
+
+  if (shard.entries_.find(key) != shard.entries_.end())
+    return false;
+  return shard.loading_.insert(std::make_pair(key, Shard::RequestList()))
+      .second;
+}
+
+void ResourceCache::EndLoad(const std::string& key,
+                            CefRefPtr<Response> response) {
+  Shard::RequestList waiting;
+  {
+    Shard& shard = GetShard(key);
+    base::AutoLock lock_scope(shard.lock_);
+
+    auto it = shard.loading_.find(key);
+    if (it == shard.loading_.end())
+      return;
+    waiting.swap(it->second);
+    shard.loading_.erase(it);
+  }
+
+  // Continue without holding the lock. Calls for requests that were canceled
+  // while waiting are ignored.
+  for (size_t i = 0; i < waiting.size(); ++i) {
+    waiting[i]->Continue(
+        response ? CreateHandler(response, waiting[i]->request()) : nullptr);
+  }
+}
+
+void ResourceCache::CompleteLoad(const std::string& key,
+                                 int status,
+                                 const std::string& status_text,
+                                 const std::string& mime_type,
+                                 const CefResponse::HeaderMap& header_map,
+                                 CefRefPtr<shared::ChunkedBuffer> body) {
+  CefRefPtr<Response> response =
+      new Response(status, status_text, mime_type, header_map, body);
+  Insert(key, response);
+  EndLoad(key, response);
+}
+
+void ResourceCache::AbortLoad(const std::string& key) {
+  EndLoad(key, nullptr);
+}
+
+// static
+CefRefPtr<CefResourceHandler> ResourceCache::CreateHandler(
+    CefRefPtr<Response> response,
+    CefRefPtr<CefRequest> request) {
+  if (!response->etag().empty() &&
+      shared::MatchesETag(request, response->etag())) {
+    // The client already has this version.
+    return new CefStreamResourceHandler(304, "Not Modified",
+                                        response->mime_type(),
+                                        response->header_map(), nullptr);
+  }
+
+  return new CefStreamResourceHandler(
+      response->status(), response->status_text(), response->mime_type(),
+      response->header_map(), response->body()->CreateReader());
+}
+
+}  // namespace resource_manager
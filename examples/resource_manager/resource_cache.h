@@ -0,0 +1,134 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_CACHE_H_
+#define CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "include/cef_resource_handler.h"
+#include "include/wrapper/cef_resource_manager.h"
+
+#include "examples/shared/chunked_buffer.h"
+
+namespace resource_manager {
+
+// In-memory cache of complete responses keyed by normalized URL. The cache is
+// split into independently locked shards that each hold an equal part of the
+// byte budget and evict the least recently used responses first. Concurrent
+// requests for the same key share a single load: while the first request's
+// response is being read the other requests wait and are then served from the
+// cache. Methods may be called on any thread.
+//
+// Usage:
+// 1. Add the Provider returned by CreateProvider() to the CefResourceManager
+//    with a lower order than the Providers whose responses should be cached.
+//    It serves cache hits and holds requests for responses that are being
+//    loaded.
+// 2. Pass the handler returned by CefResourceManager::GetResourceHandler to
+//    WrapHandler(). On a cache miss the complete response will be added to
+//    the cache as it is read and then passed to any waiting requests.
+class ResourceCache {
+ public:
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t coalesced;
+    uint64_t insertions;
+    uint64_t evictions;
+    size_t size;
+  };
+
+  explicit ResourceCache(size_t byte_budget);
+  ~ResourceCache();
+
+  // Returns a Provider that serves cache hits and ignores all other requests.
+  // The Provider must not outlive this object.
+  CefResourceManager::Provider* CreateProvider();
+
+  // Returns a handler that forwards to |handler| and adds a successful
+  // response for |request| to the cache. Returns |handler| unchanged if the
+  // response should not be cached.
+  CefRefPtr<CefResourceHandler> WrapHandler(
+      CefRefPtr<CefRequest> request,
+      CefRefPtr<CefResourceHandler> handler);
+
+  // Returns the current hit/miss/coalesced/insertion/eviction counters and the
+  // total size of cached responses.
+  Stats GetStats() const;
+
+  // Remove the responses for |url| in all encodings, including responses for
+  // |url| with a query component. |url| must not have a fragment component.
+  // Responses that are currently being loaded are not affected.
+  void Invalidate(const std::string& url);
+
+  // Complete response stored in the cache.
+  class Response;
+
+  // Returns the cache key for |request|, or an empty string if the response
+  // should not be cached.
+  static std::string GetKey(CefRefPtr<CefRequest> request);
+
+  // Continue |request| with the cached response for |key| if one exists, or
+  // hold it until the response for |key| that is currently being loaded is
+  // complete. Returns false if |request| was not handled. Updates the hit,
+  // miss and coalesced counters.
+  bool FindOrWait(const std::string& key,
+                  scoped_refptr<CefResourceManager::Request> request);
+
+  // Add |response| for |key|, evicting the least recently used responses as
+  // necessary. Responses larger than a shard's budget are not added.
+  void Insert(const std::string& key, CefRefPtr<Response> response);
+
+  // Mark the response for |key| as being loaded. Returns false if the
+  // response is already cached or being loaded by another request.
+  bool BeginLoad(const std::string& key);
+
+  // Complete a load started with BeginLoad(). Waiting requests are continued
+  // with |response|, or passed to the next Provider if |response| is nullptr.
+  // Call Insert() first so that later requests are served from the cache.
+  void EndLoad(const std::string& key, CefRefPtr<Response> response);
+
+  // Add a response with the complete contents of |body| for |key| and end the
+  // load started with BeginLoad().
+  void CompleteLoad(const std::string& key,
+                    int status,
+                    const std::string& status_text,
+                    const std::string& mime_type,
+                    const CefResponse::HeaderMap& header_map,
+                    CefRefPtr<shared::ChunkedBuffer> body);
+
+  // End the load started with BeginLoad() without a response.
+  void AbortLoad(const std::string& key);
+
+  // Returns a handler that serves |response| for |request|.
+  static CefRefPtr<CefResourceHandler> CreateHandler(
+      CefRefPtr<Response> response,
+      CefRefPtr<CefRequest> request);
+
+ private:
+  class Shard;
+
+  Shard& GetShard(const std::string& key);
+
+  const size_t shard_budget_;
+  std::unique_ptr<Shard[]> shards_;
+
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+  std::atomic<uint64_t> coalesced_;
+  std::atomic<uint64_t> insertions_;
+  std::atomic<uint64_t> evictions_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceCache);
+};
+
+}  // namespace resource_manager
+
+#endif  // CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_CACHE_H_
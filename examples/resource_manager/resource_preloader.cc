@@ -0,0 +1,183 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/resource_manager/resource_preloader.h"
+
+#include <ctype.h>
+
+#include <algorithm>
+
+#include "include/cef_request.h"
+
+#include "examples/resource_manager/resource_cache.h"
+#include "examples/shared/chunked_buffer.h"
+#include "examples/shared/resource_util.h"
+
+namespace resource_manager {
+
+namespace {
+
+// Size of the buffer used to copy response bodies.
+const size_t kCopyBufferSize = 16 * 1024;
+
+// Returns true if |html| contains the attribute |name| at |pos|, preceded by
+// whitespace and followed by "=". Sets |value_pos| to the start of the value.
+bool MatchAttribute(const std::string& html,
+                    size_t pos,
+                    const char* name,
+                    size_t& value_pos) {
+  if (pos == 0 || !isspace(static_cast<unsigned char>(html[pos - 1])))
+    return false;
+
+  size_t i = pos;
+  for (; *name; ++name, ++i) {
+    if (i == html.length() ||
+        tolower(static_cast<unsigned char>(html[i])) != *name) {
+      return false;
+    }
+  }
+
+  while (i < html.length() && isspace(static_cast<unsigned char>(html[i])))
+    ++i;
+  if (i == html.length() || html[i] != '=')
+    return false;
+  ++i;
+  while (i < html.length() && isspace(static_cast<unsigned char>(html[i])))
+    ++i;
+
+  value_pos = i;
+  return true;
+}
+
+// Returns the attribute value at |pos|, which may be quoted.
+std::string GetAttributeValue(const std::string& html, size_t pos) {
+  if (pos == html.length())
+    return std::string();
+
+  if (html[pos] == '"' || html[pos] == '\'') {
+    const size_t end = html.find(html[pos], pos + 1);
+    if (end == std::string::npos)
+      return std::string();
+    return html.substr(pos + 1, end - pos - 1);
+  }
+
+  size_t end = pos;
+  while (end < html.length() &&
+         !isspace(static_cast<unsigned char>(html[end])) && html[end] != '>') {
+    ++end;
+  }
+  return html.substr(pos, end - pos);
+}
+
+// Resolve |reference| relative to |page_url|. Returns an empty string if the
+// result would not be a simple URL on the same origin.
+std::string ResolveReference(const std::string& reference,
+                             const std::string& page_url) {
+  std::string ref = reference.substr(0, reference.find('#'));
+  if (ref.empty() || ref.find_first_of("?\\") != std::string::npos ||
+      ref.find("..") != std::string::npos) {
+    return std::string();
+  }
+
+  const size_t scheme_end = page_url.find("://");
+  if (scheme_end == std::string::npos)
+    return std::string();
+  const size_t origin_end = page_url.find('/', scheme_end + 3);
+  if (origin_end == std::string::npos)
+    return std::string();
+
+  if (ref.find(':') != std::string::npos) {
+    // Absolute URL or another scheme such as "data:" or "javascript:".
+    return ref.compare(0, origin_end + 1, page_url, 0, origin_end + 1) == 0
+               ? ref
+               : std::string();
+  }
+  if (ref.compare(0, 2, "//") == 0)
+    return std::string();
+  if (ref[0] == '/')
+    return page_url.substr(0, origin_end) + ref;
+
+  // Relative to the directory of the page.
+  const size_t path_end = page_url.find_first_of("?#", origin_end);
+  const size_t dir_end = page_url.rfind('/', path_end);
+  return page_url.substr(0, dir_end + 1) + ref;
+}
+
+// Add the response for |url| to |cache|. Does nothing if the response is
+// already cached or being loaded.
+void PreloadResource(ResourceCache* cache, const std::string& url) {
+  const std::string& resource_path = shared::GetResourcePath(url);
+  if (resource_path.empty())
+    return;
+
+  // Describe the request that the browser is expected to make.
+  CefRefPtr<CefRequest> request = CefRequest::Create();
+  request->SetURL(url);
+  request->SetMethod("GET");
+  request->SetHeaderByName("Accept-Encoding", "gzip, deflate", true);
+
+  const std::string& key = ResourceCache::GetKey(request);
+  if (!cache->BeginLoad(key)) {
+    // Requests that arrive while loading will wait for the response.
+    return;
+  }
+
+  shared::ResourceResponse resource;
+  if (!shared::GetResourceResponse(resource_path, request, resource) ||
+      resource.status != 200) {
+    cache->AbortLoad(key);
+    return;
+  }
+
+  CefRefPtr<shared::ChunkedBuffer> body = new shared::ChunkedBuffer();
+  char buffer[kCopyBufferSize];
+  size_t read;
+  while ((read = resource.reader->Read(buffer, 1, sizeof(buffer))) > 0)
+    body->Append(buffer, read);
+
+  cache->CompleteLoad(key, resource.status, resource.status_text,
+                      resource.mime_type, resource.header_map, body);
+}
+
+}  // namespace
+
+std::vector<std::string> FindPageReferences(const std::string& html,
+                                            const std::string& page_url) {
+  std::vector<std::string> urls;
+
+  for (size_t pos = 0; pos < html.length(); ++pos) {
+    const int c = tolower(static_cast<unsigned char>(html[pos]));
+    if (c != 's' && c != 'h')
+      continue;
+
+    size_t value_pos;
+    if (!MatchAttribute(html, pos, "src", value_pos) &&
+        !MatchAttribute(html, pos, "href", value_pos)) {
+      continue;
+    }
+
+    const std::string& url =
+        ResolveReference(GetAttributeValue(html, value_pos), page_url);
+    if (!url.empty() && std::find(urls.begin(), urls.end(), url) == urls.end())
+      urls.push_back(url);
+    pos = value_pos;
+  }
+
+  return urls;
+}
+
+void PreloadResources(ResourceCache* cache, const std::string& page_url) {
+  PreloadResource(cache, page_url);
+
+  const std::string& page_path = shared::GetResourcePath(page_url);
+  std::string html;
+  if (page_path.empty() || !shared::GetResourceString(page_path, html))
+    return;
+
+  const std::vector<std::string>& urls = FindPageReferences(html, page_url);
+  for (size_t i = 0; i < urls.size(); ++i)
+    PreloadResource(cache, urls[i]);
+}
+
+}  // namespace resource_manager
@@ -0,0 +1,32 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_PRELOADER_H_
+#define CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_PRELOADER_H_
+
+#include <string>
+#include <vector>
+
+namespace resource_manager {
+
+class ResourceCache;
+
+// Returns the URLs referenced by "src" and "href" attributes in |html|,
+// resolved relative to |page_url|. Only references that remain on the origin
+// of |page_url| and have no query component are returned. Fragments are
+// removed. Duplicates are removed.
+std::vector<std::string> FindPageReferences(const std::string& html,
+                                            const std::string& page_url);
+
+// Add the responses for |page_url| and the resources that it references to
+// |cache| so that they are ready before the browser requests them. Responses
+// are created from the resource index using the same headers as
+// shared::GetResourceHandler for a request that accepts gzip. Resources that
+// are not in the index are skipped. Blocks until complete so it should be
+// called on a worker thread.
+void PreloadResources(ResourceCache* cache, const std::string& page_url);
+
+}  // namespace resource_manager
+
+#endif  // CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_PRELOADER_H_
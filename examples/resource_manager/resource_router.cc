@@ -0,0 +1,161 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/resource_manager/resource_router.h"
+
+#include "include/wrapper/cef_helpers.h"
+
+namespace resource_manager {
+
+namespace {
+
+// Returns |url| without the query and fragment components.
+std::string GetRouteKey(const std::string& url) {
+  return url.substr(0, url.find_first_of("?#"));
+}
+
+}  // namespace
+
+// Tree node. The key of a node is the concatenation of the labels on the path
+// from the root. Children are indexed by the first character of their label,
+// which is unique among siblings.
+class ResourceRouter::Node {
+ public:
+  Node() {}
+  explicit Node(const std::string& label) : label_(label) {}
+
+  Node* FindChild(char c) const {
+    ChildMap::const_iterator it = children_.find(c);
+    return it == children_.end() ? nullptr : it->second.get();
+  }
+
+  std::string label_;
+
+  typedef std::map<char, std::unique_ptr<Node>> ChildMap;
+  ChildMap children_;
+
+  std::vector<CefResourceManager::Provider*> exact_providers_;
+  std::vector<CefResourceManager::Provider*> prefix_providers_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(Node);
+};
+
+ResourceRouter::ResourceRouter() : root_(new Node()) {}
+
+ResourceRouter::~ResourceRouter() {}
+
+void ResourceRouter::AddExactRoute(const std::string& url,
+                                   CefResourceManager::Provider* provider) {
+  DCHECK(provider);
+  providers_.push_back(std::unique_ptr<CefResourceManager::Provider>(provider));
+  InsertNode(GetRouteKey(url))->exact_providers_.push_back(provider);
+}
+
+void ResourceRouter::AddPrefixRoute(const std::string& url_prefix,
+                                    CefResourceManager::Provider* provider) {
+  DCHECK(provider);
+  providers_.push_back(std::unique_ptr<CefResourceManager::Provider>(provider));
+  InsertNode(url_prefix)->prefix_providers_.push_back(provider);
+}
+
+bool ResourceRouter::OnRequest(
+    scoped_refptr<CefResourceManager::Request> request) {
+  CEF_REQUIRE_IO_THREAD();
+
+  std::vector<CefResourceManager::Provider*> providers;
+  FindProviders(request->url(), providers);
+  for (size_t i = 0; i < providers.size(); ++i) {
+    if (providers[i]->OnRequest(request))
+      return true;
+  }
+
+  // Not handled by this provider.
+  return false;
+}
+
+void ResourceRouter::OnRequestCanceled(
+    scoped_refptr<CefResourceManager::Request> request) {
+  CEF_REQUIRE_IO_THREAD();
+
+  // The Provider that handled the request isn't tracked. Providers ignore
+  // requests that they didn't handle.
+  std::vector<CefResourceManager::Provider*> providers;
+  FindProviders(request->url(), providers);
+  for (size_t i = 0; i < providers.size(); ++i)
+    providers[i]->OnRequestCanceled(request);
+}
+
+ResourceRouter::Node* ResourceRouter::InsertNode(const std::string& key) {
+  Node* node = root_.get();
+  size_t pos = 0;
+
+  while (pos < key.length()) {
+    std::unique_ptr<Node>& slot = node->children_[key[pos]];
+    if (!slot) {
+      // No route shares this prefix. Add a leaf for the rest of the key.
+      slot.reset(new Node(key.substr(pos)));
+      return slot.get();
+    }
+
+    // Length of the prefix shared by the child's label and the rest of the
+    // key.
+    const std::string& label = slot->label_;
+    size_t common = 1;
+    while (common < label.length() && pos + common < key.length() &&
+           label[common] == key[pos + common]) {
+      ++common;
+    }
+
+    if (common < label.length()) {
+      // Split the child so that the shared prefix gets its own node.
+      std::unique_ptr<Node> split(new Node(label.substr(0, common)));
+      slot->label_.erase(0, common);
+      const char c = slot->label_[0];
+      split->children_[c] = std::move(slot);
+      slot = std::move(split);
+    }
+
+    node = slot.get();
+    pos += common;
+  }
+
+  return node;
+}
+
+void ResourceRouter::FindProviders(
+    const std::string& url,
+    std::vector<CefResourceManager::Provider*>& providers) const {
+  const std::string& key = GetRouteKey(url);
+
+  // Nodes with prefix routes along the path, from shortest to longest.
+  std::vector<const Node*> prefix_nodes;
+
+  const Node* node = root_.get();
+  size_t pos = 0;
+  while (true) {
+    if (!node->prefix_providers_.empty())
+      prefix_nodes.push_back(node);
+    if (pos == key.length())
+      break;
+
+    const Node* child = node->FindChild(key[pos]);
+    if (!child || key.compare(pos, child->label_.length(), child->label_) != 0)
+      break;
+    node = child;
+    pos += child->label_.length();
+  }
+
+  if (pos == key.length()) {
+    providers.insert(providers.end(), node->exact_providers_.begin(),
+                     node->exact_providers_.end());
+  }
+  for (size_t i = prefix_nodes.size(); i > 0; --i) {
+    const Node* prefix_node = prefix_nodes[i - 1];
+    providers.insert(providers.end(), prefix_node->prefix_providers_.begin(),
+                     prefix_node->prefix_providers_.end());
+  }
+}
+
+}  // namespace resource_manager
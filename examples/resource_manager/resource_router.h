@@ -0,0 +1,68 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_ROUTER_H_
+#define CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_ROUTER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "include/wrapper/cef_resource_manager.h"
+
+namespace resource_manager {
+
+// Provider that dispatches requests to other Providers using a compressed
+// radix tree of URLs. Finding the Providers for a request costs a single
+// traversal of the tree regardless of the number of routes, instead of calling
+// every Provider in turn as CefResourceManager does. URLs are matched without
+// the query and fragment components. Must be used on the browser process IO
+// thread after construction.
+//
+// For each request the Providers registered for the exact URL are called
+// first, followed by the Providers registered for matching prefixes from the
+// longest prefix to the shortest. Providers registered for the same route are
+// called in registration order. Dispatch stops at the first Provider that
+// handles the request.
+class ResourceRouter : public CefResourceManager::Provider {
+ public:
+  ResourceRouter();
+  ~ResourceRouter() override;
+
+  // Route requests for |url| to |provider|. Takes ownership of |provider|.
+  void AddExactRoute(const std::string& url,
+                     CefResourceManager::Provider* provider);
+
+  // Route requests for URLs that start with |url_prefix| to |provider|. Takes
+  // ownership of |provider|.
+  void AddPrefixRoute(const std::string& url_prefix,
+                      CefResourceManager::Provider* provider);
+
+  // CefResourceManager::Provider methods. OnRequestCanceled is forwarded to
+  // every Provider whose route matches the request.
+  bool OnRequest(scoped_refptr<CefResourceManager::Request> request) override;
+  void OnRequestCanceled(
+      scoped_refptr<CefResourceManager::Request> request) override;
+
+ private:
+  class Node;
+
+  // Returns the node for |key|, splitting and adding nodes as necessary.
+  Node* InsertNode(const std::string& key);
+
+  // Add the Providers for |url| to |providers| in dispatch order.
+  void FindProviders(const std::string& url,
+                     std::vector<CefResourceManager::Provider*>& providers)
+      const;
+
+  std::unique_ptr<Node> root_;
+  std::vector<std::unique_ptr<CefResourceManager::Provider>> providers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceRouter);
+};
+
+}  // namespace resource_manager
+
+#endif  // CEF_EXAMPLES_RESOURCE_MANAGER_RESOURCE_ROUTER_H_
@@ -4,6 +4,13 @@
 
 #include "examples/scheme_handler/scheme_handler_impl.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "include/base/cef_lock.h"
 #include "include/cef_browser.h"
 #include "include/cef_callback.h"
 #include "include/cef_frame.h"
@@ -11,54 +18,164 @@
 #include "include/cef_resource_handler.h"
 #include "include/cef_response.h"
 #include "include/cef_scheme.h"
+#include "include/cef_stream.h"
+#include "include/cef_task.h"
 #include "include/wrapper/cef_helpers.h"
 
 #include "examples/scheme_handler/scheme_strings.h"
+#include "examples/shared/chunked_buffer.h"
 #include "examples/shared/client_util.h"
+#include "examples/shared/resource_template.h"
 #include "examples/shared/resource_util.h"
+#include "examples/shared/worker_pool.h"
 
 namespace scheme_handler {
 
 namespace {
 
-// Implementation of the scheme handler for client:// requests.
-class ClientSchemeHandler : public CefResourceHandler {
+// Result of parsing a "Range" request header.
+enum RangeResult {
+  // No usable range. The complete resource should be returned.
+  RANGE_NONE,
+  // A single satisfiable byte range.
+  RANGE_VALID,
+  // A syntactically valid range that lies outside of the resource.
+  RANGE_UNSATISFIABLE,
+};
+
+// Parse a single "bytes=first-last", "bytes=first-" or "bytes=-suffix" range
+// for a resource of |size| bytes. Multiple ranges are not supported and will
+// result in the complete resource being returned.
+RangeResult ParseRange(const std::string& header,
+                       int64_t size,
+                       int64_t& first,
+                       int64_t& last) {
+  static const char kPrefix[] = "bytes=";
+  if (header.compare(0, sizeof(kPrefix) - 1, kPrefix) != 0 ||
+      header.find(',') != std::string::npos) {
+    return RANGE_NONE;
+  }
+
+  const std::string& spec = header.substr(sizeof(kPrefix) - 1);
+  const size_t dash = spec.find('-');
+  if (dash == std::string::npos ||
+      spec.find_first_not_of("0123456789-") != std::string::npos) {
+    return RANGE_NONE;
+  }
+
+  const std::string& first_str = spec.substr(0, dash);
+  const std::string& last_str = spec.substr(dash + 1);
+  if (first_str.empty()) {
+    // Suffix range specifying the number of bytes at the end.
+    if (last_str.empty())
+      return RANGE_NONE;
+    const int64_t suffix = strtoll(last_str.c_str(), nullptr, 10);
+    if (suffix <= 0 || size == 0)
+      return RANGE_UNSATISFIABLE;
+    first = std::max<int64_t>(size - suffix, 0);
+    last = size - 1;
+    return RANGE_VALID;
+  }
+
+  first = strtoll(first_str.c_str(), nullptr, 10);
+  last = last_str.empty() ? size - 1 : strtoll(last_str.c_str(), nullptr, 10);
+  if (last < first)
+    return RANGE_NONE;
+  if (first >= size)
+    return RANGE_UNSATISFIABLE;
+  last = std::min(last, size - 1);
+  return RANGE_VALID;
+}
+
+// Maximum number of idle handlers kept for reuse.
+const size_t kMaxPooledHandlers = 256;
+
+class ClientSchemeHandler;
+
+// Free list of idle ClientSchemeHandler objects. Handlers return themselves to
+// the pool when their last reference is released, so a page that loads many
+// client:// resources reuses a small number of handler allocations. Methods
+// may be called on any thread.
+class HandlerPool {
  public:
-  ClientSchemeHandler() : offset_(0) {}
+  HandlerPool() : allocated_(0), reused_(0), discarded_(0) {}
 
-  bool ProcessRequest(CefRefPtr<CefRequest> request,
-                      CefRefPtr<CefCallback> callback) override {
-    CEF_REQUIRE_IO_THREAD();
+  // Returns an idle handler, or a new handler if the pool is empty.
+  ClientSchemeHandler* Take();
 
-    bool handled = false;
+  // Called when the last reference to |handler| has been released.
+  void Recycle(ClientSchemeHandler* handler);
 
-    std::string url = request->GetURL();
-    if (strstr(url.c_str(), kFileName) != nullptr) {
-      // Load the response html.
-      if (shared::GetResourceString(kFileName, data_)) {
-        // Insert the request contents.
-        const std::string& find = "$REQUEST$";
-        const std::string& replace = shared::DumpRequestContents(request);
-        data_.replace(data_.find(find), find.size(), replace);
+  SchemeHandlerPoolStats GetStats() const;
 
-        handled = true;
-        mime_type_ = "text/html";
-      }
-    } else if (strstr(url.c_str(), "logo.png") != nullptr) {
-      // Load the response image.
-      if (shared::GetResourceString("logo.png", data_)) {
-        handled = true;
-        mime_type_ = "image/png";
-      }
+ private:
+  mutable base::Lock lock_;
+  std::vector<ClientSchemeHandler*> handlers_;
+  uint64_t allocated_;
+  uint64_t reused_;
+  uint64_t discarded_;
+
+  DISALLOW_COPY_AND_ASSIGN(HandlerPool);
+};
+
+// Pool used by the registered factory. Intentionally leaked so that it
+// outlives all handlers.
+HandlerPool* g_handler_pool = nullptr;
+
+// Implementation of the scheme handler for client:// requests. Resources are
+// streamed from the resource pack without copying, precompressed variants are
+// served to clients that accept gzip and byte range requests are supported so
+// that media elements can seek. Blocking work is performed on the
+// shared::WorkerPool so that slow disk access does not stall other requests.
+// Instances are reused via HandlerPool.
+class ClientSchemeHandler : public CefResourceHandler {
+ public:
+  explicit ClientSchemeHandler(HandlerPool* pool)
+      : pool_(pool), status_(0), remaining_(0), may_block_(false) {}
+
+  // CefBaseRefCounted methods. The handler is returned to |pool_| instead of
+  // being deleted when the last reference is released.
+  void AddRef() const override { ref_count_.AddRef(); }
+  bool Release() const override {
+    if (ref_count_.Release()) {
+      pool_->Recycle(const_cast<ClientSchemeHandler*>(this));
+      return true;
     }
+    return false;
+  }
+  bool HasOneRef() const override { return ref_count_.HasOneRef(); }
+  bool HasAtLeastOneRef() const override {
+    return ref_count_.HasAtLeastOneRef();
+  }
 
-    if (handled) {
-      // Indicate that the headers are available.
-      callback->Continue();
+  // Clear all per-request state. String members keep their capacity. Only
+  // called when no references remain.
+  void Reset() {
+    stream_ = nullptr;
+    mime_type_.clear();
+    header_map_.clear();
+    status_ = 0;
+    remaining_ = 0;
+    may_block_ = false;
+  }
+
+  bool Open(CefRefPtr<CefRequest> request,
+            bool& handle_request,
+            CefRefPtr<CefCallback> callback) override {
+    DCHECK(!CefCurrentlyOn(TID_UI) && !CefCurrentlyOn(TID_IO));
+
+    // Opening the resource may page in data from disk so continue on a worker
+    // thread if possible.
+    if (shared::WorkerPool::PostTask(
+            base::BindOnce(&ClientSchemeHandler::OpenOnWorker,
+                           CefRefPtr<ClientSchemeHandler>(this), request,
+                           callback))) {
+      handle_request = false;
       return true;
     }
 
-    return false;
+    handle_request = true;
+    return OpenResource(request);
   }
 
   void GetResponseHeaders(CefRefPtr<CefResponse> response,
@@ -66,64 +183,311 @@ class ClientSchemeHandler : public CefResourceHandler {
                           CefString& redirectUrl) override {
     CEF_REQUIRE_IO_THREAD();
 
-    DCHECK(!data_.empty());
+    DCHECK(stream_);
 
     response->SetMimeType(mime_type_);
-    response->SetStatus(200);
+    response->SetStatus(status_);
+    response->SetHeaderMap(header_map_);
 
     // Set the resulting response length.
-    response_length = data_.length();
+    response_length = remaining_;
   }
 
   void Cancel() override { CEF_REQUIRE_IO_THREAD(); }
 
-  bool ReadResponse(void* data_out,
-                    int bytes_to_read,
-                    int& bytes_read,
-                    CefRefPtr<CefCallback> callback) override {
-    CEF_REQUIRE_IO_THREAD();
+  bool Skip(int64_t bytes_to_skip,
+            int64_t& bytes_skipped,
+            CefRefPtr<CefResourceSkipCallback> callback) override {
+    DCHECK(!CefCurrentlyOn(TID_UI) && !CefCurrentlyOn(TID_IO));
+
+    // Seek forward without reading the skipped bytes.
+    const int64_t skip = std::min(bytes_to_skip, remaining_);
+    if (skip <= 0 || stream_->Seek(skip, SEEK_CUR) != 0) {
+      bytes_skipped = ERR_FAILED;
+      return false;
+    }
+
+    remaining_ -= skip;
+    bytes_skipped = skip;
+    return true;
+  }
+
+  bool Read(void* data_out,
+            int bytes_to_read,
+            int& bytes_read,
+            CefRefPtr<CefResourceReadCallback> callback) override {
+    DCHECK(!CefCurrentlyOn(TID_UI) && !CefCurrentlyOn(TID_IO));
 
-    bool has_data = false;
     bytes_read = 0;
+    if (remaining_ <= 0) {
+      // The response is complete. Release the stream now instead of when the
+      // handler is recycled.
+      stream_ = nullptr;
+      return false;
+    }
 
-    if (offset_ < data_.length()) {
-      // Copy the next block of data into the buffer.
-      int transfer_size =
-          std::min(bytes_to_read, static_cast<int>(data_.length() - offset_));
-      memcpy(data_out, data_.c_str() + offset_, transfer_size);
-      offset_ += transfer_size;
+    const size_t read_size = static_cast<size_t>(
+        std::min(static_cast<int64_t>(bytes_to_read), remaining_));
 
-      bytes_read = transfer_size;
-      has_data = true;
+    // |data_out| remains valid until |callback| is executed.
+    if (may_block_ &&
+        shared::WorkerPool::PostTask(base::BindOnce(
+            &ClientSchemeHandler::ReadOnWorker,
+            CefRefPtr<ClientSchemeHandler>(this), data_out, read_size,
+            callback))) {
+      return true;
     }
 
-    return has_data;
+    bytes_read = ReadStream(data_out, read_size);
+    return bytes_read > 0;
   }
 
  private:
-  std::string data_;
+  // Returns the "client://tests/" origin.
+  static const std::string& GetOrigin() {
+    static const std::string origin =
+        std::string(kScheme) + "://" + kDomain + "/";
+    return origin;
+  }
+
+  void OpenOnWorker(CefRefPtr<CefRequest> request,
+                    CefRefPtr<CefCallback> callback) {
+    if (OpenResource(request))
+      callback->Continue();
+    else
+      callback->Cancel();
+  }
+
+  void ReadOnWorker(void* data_out,
+                    size_t read_size,
+                    CefRefPtr<CefResourceReadCallback> callback) {
+    const int bytes_read = ReadStream(data_out, read_size);
+    callback->Continue(bytes_read > 0 ? bytes_read : ERR_FAILED);
+  }
+
+  // Locate the resource for |request| and compute the response. Returns false
+  // if the resource does not exist.
+  bool OpenResource(CefRefPtr<CefRequest> request) {
+    const std::string& resource_path =
+        shared::GetResourcePath(request->GetURL(), GetOrigin());
+    if (resource_path.empty())
+      return false;
+
+    int64_t size = 0;
+    bool gzip = false;
+    if (resource_path == kFileName) {
+      // Render the response html from the parsed template.
+      CefRefPtr<shared::ResourceTemplate> page =
+          shared::ResourceTemplate::Get(kFileName);
+      if (!page)
+        return false;
+
+      // Insert the request contents.
+      CefRefPtr<shared::ChunkedBuffer> dump = new shared::ChunkedBuffer();
+      shared::DumpRequestContents(request, *dump);
+      shared::ResourceTemplate::ValueMap values;
+      values["REQUEST"] = dump;
+
+      // Insert the handler pool counters.
+      const SchemeHandlerPoolStats& stats = GetSchemeHandlerPoolStats();
+      char pool_stats[128];
+      snprintf(pool_stats, sizeof(pool_stats),
+               "allocated=%llu reused=%llu discarded=%llu pooled=%zu",
+               static_cast<unsigned long long>(stats.allocated),
+               static_cast<unsigned long long>(stats.reused),
+               static_cast<unsigned long long>(stats.discarded), stats.pooled);
+      CefRefPtr<shared::ChunkedBuffer> pool = new shared::ChunkedBuffer();
+      pool->Append(pool_stats);
+      values["POOL_STATS"] = pool;
+
+      size_t page_size = 0;
+      stream_ = page->Render(values, page_size);
+      size = static_cast<int64_t>(page_size);
+      mime_type_ = "text/html";
+
+      // The contents are different for every request.
+      header_map_.insert(std::make_pair("Cache-Control", "no-store"));
+    } else {
+      // Stream any other resource directly from the resource pack.
+      CefRefPtr<CefBaseRefCounted> holder;
+      const shared::ResourceEntry* entry =
+          shared::GetResourceEntry(resource_path, holder);
+      if (!entry)
+        return false;
+
+      // Serve the precompressed variant if the client accepts it. Byte ranges
+      // apply to the uncompressed contents so range requests are always
+      // served uncompressed.
+      gzip = entry->gzip_data && request->GetHeaderByName("Range").empty() &&
+             shared::AcceptsEncoding(request, "gzip");
+      if (gzip) {
+        stream_ = shared::CreateMemoryReader(entry->gzip_data,
+                                             entry->gzip_size, nullptr);
+        size = static_cast<int64_t>(entry->gzip_size);
+        header_map_.insert(std::make_pair("Content-Encoding", "gzip"));
+      } else {
+        stream_ = shared::GetResourceReader(resource_path);
+        if (!stream_)
+          return false;
+        size = static_cast<int64_t>(entry->size);
+      }
+
+      mime_type_ = entry->mime_type[0] ? entry->mime_type
+                                       : shared::GetMimeType(resource_path);
+
+      // Reads may page in data from disk.
+      may_block_ = true;
+
+      if (entry->gzip_data) {
+        // The response depends on the request headers so caches must key on
+        // "Accept-Encoding".
+        header_map_.insert(std::make_pair("Vary", "Accept-Encoding"));
+      }
+
+      const std::string& etag = shared::GetResourceETag(*entry, gzip);
+      header_map_.insert(std::make_pair("ETag", etag));
+      // Files in the resource directory may change at any time.
+      header_map_.insert(std::make_pair(
+          "Cache-Control", holder ? shared::kResourceDirCacheControl
+                                  : shared::kResourceCacheControl));
+
+      if (shared::MatchesETag(request, etag)) {
+        // The client already has this version. Don't touch the body.
+        status_ = 304;
+        remaining_ = 0;
+        return true;
+      }
+    }
+
+    if (gzip) {
+      // The complete compressed contents are always returned.
+      status_ = 200;
+      remaining_ = size;
+      return true;
+    }
+
+    header_map_.insert(std::make_pair("Accept-Ranges", "bytes"));
+
+    int64_t first = 0, last = size - 1;
+    switch (ParseRange(request->GetHeaderByName("Range"), size, first, last)) {
+      case RANGE_NONE:
+        status_ = 200;
+        remaining_ = size;
+        break;
+      case RANGE_VALID: {
+        // Position the stream at the start of the range. Only the requested
+        // bytes will be read.
+        if (stream_->Seek(first, SEEK_SET) != 0)
+          return false;
+        status_ = 206;
+        remaining_ = last - first + 1;
+        char range[80];
+        snprintf(range, sizeof(range), "bytes %lld-%lld/%lld",
+                 static_cast<long long>(first), static_cast<long long>(last),
+                 static_cast<long long>(size));
+        header_map_.insert(std::make_pair("Content-Range", range));
+        break;
+      }
+      case RANGE_UNSATISFIABLE: {
+        status_ = 416;
+        remaining_ = 0;
+        char range[48];
+        snprintf(range, sizeof(range), "bytes */%lld",
+                 static_cast<long long>(size));
+        header_map_.insert(std::make_pair("Content-Range", range));
+        break;
+      }
+    }
+
+    return true;
+  }
+
+  // Read up to |read_size| bytes from |stream_|. Returns the number of bytes
+  // read.
+  int ReadStream(void* data_out, size_t read_size) {
+    const int bytes_read =
+        static_cast<int>(stream_->Read(data_out, 1, read_size));
+    remaining_ -= bytes_read;
+    return bytes_read;
+  }
+
+  HandlerPool* const pool_;
+  CefRefCount ref_count_;
+
+  // Members are only accessed by one thread at a time. Open, Read and Skip
+  // are called in sequence and the next call does not occur until the
+  // previous asynchronous operation has completed. Per-request state is not
+  // cleared on Cancel because a read may still be running on a worker thread.
+  CefRefPtr<CefStreamReader> stream_;
   std::string mime_type_;
-  size_t offset_;
+  CefResponse::HeaderMap header_map_;
+  int status_;
+
+  // Number of bytes left to read from |stream_|.
+  int64_t remaining_;
+
+  // True if reading from |stream_| may block on disk access.
+  bool may_block_;
 
-  IMPLEMENT_REFCOUNTING(ClientSchemeHandler);
   DISALLOW_COPY_AND_ASSIGN(ClientSchemeHandler);
 };
 
+ClientSchemeHandler* HandlerPool::Take() {
+  {
+    base::AutoLock lock_scope(lock_);
+    if (!handlers_.empty()) {
+      ClientSchemeHandler* handler = handlers_.back();
+      handlers_.pop_back();
+      ++reused_;
+      return handler;
+    }
+    ++allocated_;
+  }
+  return new ClientSchemeHandler(this);
+}
+
+void HandlerPool::Recycle(ClientSchemeHandler* handler) {
+  // Release per-request resources outside of the lock.
+  handler->Reset();
+
+  {
+    base::AutoLock lock_scope(lock_);
+    if (handlers_.size() < kMaxPooledHandlers) {
+      handlers_.push_back(handler);
+      return;
+    }
+    ++discarded_;
+  }
+  delete handler;
+}
+
+SchemeHandlerPoolStats HandlerPool::GetStats() const {
+  base::AutoLock lock_scope(lock_);
+  SchemeHandlerPoolStats stats;
+  stats.allocated = allocated_;
+  stats.reused = reused_;
+  stats.discarded = discarded_;
+  stats.pooled = handlers_.size();
+  return stats;
+}
+
 // Implementation of the factory for creating scheme handlers.
 class ClientSchemeHandlerFactory : public CefSchemeHandlerFactory {
  public:
-  ClientSchemeHandlerFactory() {}
+  explicit ClientSchemeHandlerFactory(HandlerPool* pool) : pool_(pool) {}
 
-  // Return a new scheme handler instance to handle the request.
+  // Return a pooled scheme handler instance to handle the request.
   CefRefPtr<CefResourceHandler> Create(CefRefPtr<CefBrowser> browser,
                                        CefRefPtr<CefFrame> frame,
                                        const CefString& scheme_name,
                                        CefRefPtr<CefRequest> request) override {
     CEF_REQUIRE_IO_THREAD();
-    return new ClientSchemeHandler();
+    return pool_->Take();
   }
 
  private:
+  HandlerPool* const pool_;
+
   IMPLEMENT_REFCOUNTING(ClientSchemeHandlerFactory);
   DISALLOW_COPY_AND_ASSIGN(ClientSchemeHandlerFactory);
 };
@@ -131,8 +495,16 @@ class ClientSchemeHandlerFactory : public CefSchemeHandlerFactory {
 }  // namespace
 
 void RegisterSchemeHandlerFactory() {
-  CefRegisterSchemeHandlerFactory(kScheme, kDomain,
-                                  new ClientSchemeHandlerFactory());
+  if (!g_handler_pool)
+    g_handler_pool = new HandlerPool();
+  CefRegisterSchemeHandlerFactory(
+      kScheme, kDomain, new ClientSchemeHandlerFactory(g_handler_pool));
+}
+
+SchemeHandlerPoolStats GetSchemeHandlerPoolStats() {
+  if (!g_handler_pool)
+    return SchemeHandlerPoolStats();
+  return g_handler_pool->GetStats();
 }
 
 }  // namespace scheme_handler
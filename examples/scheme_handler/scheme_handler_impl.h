@@ -5,11 +5,30 @@
 #ifndef CEF_EXAMPLES_SCHEME_HANDLER_SCHEME_HANDLER_IMPL_H_
 #define CEF_EXAMPLES_SCHEME_HANDLER_SCHEME_HANDLER_IMPL_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 namespace scheme_handler {
 
 // Create and register the custom scheme handler factory.
 void RegisterSchemeHandlerFactory();
 
+// Counters for the pool of reusable scheme handler objects.
+struct SchemeHandlerPoolStats {
+  // Handlers allocated because the pool was empty.
+  uint64_t allocated;
+  // Handlers taken from the pool.
+  uint64_t reused;
+  // Handlers deleted because the pool was full.
+  uint64_t discarded;
+  // Handlers currently in the pool.
+  size_t pooled;
+};
+
+// Returns the current pool counters for the registered factory. May be called
+// on any thread.
+SchemeHandlerPoolStats GetSchemeHandlerPoolStats();
+
 }  // namespace scheme_handler
 
 #endif  // CEF_EXAMPLES_SCHEME_HANDLER_SCHEME_HANDLER_IMPL_H_
@@ -0,0 +1,292 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/shared/chunked_buffer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "include/base/cef_lock.h"
+
+namespace shared {
+
+namespace {
+
+// Size of regular chunks. Larger allocations use a dedicated chunk.
+const size_t kChunkSize = 16 * 1024;
+
+// Maximum number of regular chunks kept on the free list.
+const size_t kMaxFreeChunks = 64;
+
+// Read handler that presents a sequence of memory blocks as a single stream.
+class BlockReadHandler : public CefReadHandler {
+ public:
+  BlockReadHandler(BlockList blocks,
+                   std::vector<CefRefPtr<CefBaseRefCounted>> owners)
+      : blocks_(std::move(blocks)),
+        owners_(std::move(owners)),
+        size_(0),
+        position_(0),
+        block_(0),
+        block_offset_(0) {
+    for (size_t i = 0; i < blocks_.size(); ++i)
+      size_ += blocks_[i].second;
+  }
+
+  size_t Read(void* ptr, size_t size, size_t n) override {
+    base::AutoLock lock_scope(lock_);
+    if (size == 0)
+      return 0;
+
+    // Only read whole items, like fread.
+    char* out = static_cast<char*>(ptr);
+    size_t remaining = std::min((size_ - position_) / size, n) * size;
+    size_t copied = 0;
+
+    // Copy from consecutive blocks until the request is satisfied.
+    while (remaining > 0 && block_ < blocks_.size()) {
+      const std::pair<const char*, size_t>& block = blocks_[block_];
+      const size_t chunk = std::min(remaining, block.second - block_offset_);
+      memcpy(out + copied, block.first + block_offset_, chunk);
+      copied += chunk;
+      remaining -= chunk;
+      block_offset_ += chunk;
+      if (block_offset_ == block.second) {
+        ++block_;
+        block_offset_ = 0;
+      }
+    }
+
+    position_ += copied;
+    return copied / size;
+  }
+
+  int Seek(int64_t offset, int whence) override {
+    base::AutoLock lock_scope(lock_);
+
+    int64_t position;
+    switch (whence) {
+      case SEEK_CUR:
+        position = static_cast<int64_t>(position_) + offset;
+        break;
+      case SEEK_END:
+        position = static_cast<int64_t>(size_) + offset;
+        break;
+      case SEEK_SET:
+        position = offset;
+        break;
+      default:
+        return -1;
+    }
+    if (position < 0 || position > static_cast<int64_t>(size_))
+      return -1;
+
+    // Locate the block that contains the new position.
+    position_ = static_cast<size_t>(position);
+    block_ = 0;
+    block_offset_ = position_;
+    while (block_ < blocks_.size() && block_offset_ >= blocks_[block_].second) {
+      block_offset_ -= blocks_[block_].second;
+      ++block_;
+    }
+    return 0;
+  }
+
+  int64_t Tell() override {
+    base::AutoLock lock_scope(lock_);
+    return static_cast<int64_t>(position_);
+  }
+
+  int Eof() override {
+    base::AutoLock lock_scope(lock_);
+    return position_ >= size_;
+  }
+
+  bool MayBlock() override { return false; }
+
+ private:
+  const BlockList blocks_;
+  const std::vector<CefRefPtr<CefBaseRefCounted>> owners_;
+  size_t size_;
+
+  base::Lock lock_;
+  size_t position_;
+
+  // Current block index and offset within that block.
+  size_t block_;
+  size_t block_offset_;
+
+  IMPLEMENT_REFCOUNTING(BlockReadHandler);
+  DISALLOW_COPY_AND_ASSIGN(BlockReadHandler);
+};
+
+// Process-wide list of unused regular chunk allocations. Intentionally leaked.
+class ChunkFreeList {
+ public:
+  ChunkFreeList() {}
+
+  // Returns nullptr if the list is empty.
+  char* Take() {
+    base::AutoLock lock_scope(lock_);
+    if (chunks_.empty())
+      return nullptr;
+    char* data = chunks_.back();
+    chunks_.pop_back();
+    return data;
+  }
+
+  // Returns false if the list is full, in which case the caller should delete
+  // |data|.
+  bool Put(char* data) {
+    base::AutoLock lock_scope(lock_);
+    if (chunks_.size() >= kMaxFreeChunks)
+      return false;
+    chunks_.push_back(data);
+    return true;
+  }
+
+ private:
+  base::Lock lock_;
+  std::vector<char*> chunks_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkFreeList);
+};
+
+ChunkFreeList* GetChunkFreeList() {
+  static ChunkFreeList* list = new ChunkFreeList();
+  return list;
+}
+
+// Reference counted owner of a moved-in container.
+template <class T>
+class OwnedData : public CefBaseRefCounted {
+ public:
+  explicit OwnedData(T value) : value_(std::move(value)) {}
+
+  const T& value() const { return value_; }
+
+ private:
+  const T value_;
+
+  IMPLEMENT_REFCOUNTING(OwnedData);
+  DISALLOW_COPY_AND_ASSIGN(OwnedData);
+};
+
+template <class T>
+CefRefPtr<CefStreamReader> CreateOwnedDataReader(T data) {
+  CefRefPtr<OwnedData<T>> owner = new OwnedData<T>(std::move(data));
+  return CreateMemoryReader(owner->value().data(), owner->value().size(),
+                            owner.get());
+}
+
+}  // namespace
+
+ChunkedBuffer::ChunkedBuffer() : size_(0) {}
+
+ChunkedBuffer::~ChunkedBuffer() {
+  for (size_t i = 0; i < chunks_.size(); ++i) {
+    const Chunk& chunk = chunks_[i];
+    if (chunk.capacity != kChunkSize || !GetChunkFreeList()->Put(chunk.data))
+      delete[] chunk.data;
+  }
+}
+
+// static
+ChunkedBuffer::Chunk ChunkedBuffer::NewChunk(size_t size) {
+  Chunk chunk = {nullptr, std::max(size, kChunkSize), 0};
+  if (chunk.capacity == kChunkSize)
+    chunk.data = GetChunkFreeList()->Take();
+  if (!chunk.data)
+    chunk.data = new char[chunk.capacity];
+  return chunk;
+}
+
+void ChunkedBuffer::Append(const char* data, size_t size) {
+  while (size > 0) {
+    if (chunks_.empty() || chunks_.back().used == chunks_.back().capacity)
+      chunks_.push_back(NewChunk(kChunkSize));
+
+    // Fill the remaining space in the last chunk.
+    Chunk& chunk = chunks_.back();
+    const size_t copy_size = std::min(size, chunk.capacity - chunk.used);
+    memcpy(chunk.data + chunk.used, data, copy_size);
+    chunk.used += copy_size;
+    size_ += copy_size;
+    data += copy_size;
+    size -= copy_size;
+  }
+}
+
+void ChunkedBuffer::Append(const char* value) {
+  Append(value, strlen(value));
+}
+
+void ChunkedBuffer::Append(const CefString& value) {
+  Append(value.ToString());
+}
+
+void ChunkedBuffer::Append(size_t value) {
+  char buff[32];
+  const int length = snprintf(buff, sizeof(buff), "%zu", value);
+  Append(buff, static_cast<size_t>(length));
+}
+
+char* ChunkedBuffer::Allocate(size_t size) {
+  if (chunks_.empty() ||
+      chunks_.back().capacity - chunks_.back().used < size) {
+    // Any unused space in the previous chunk is left empty.
+    chunks_.push_back(NewChunk(size));
+  }
+
+  Chunk& chunk = chunks_.back();
+  char* data = chunk.data + chunk.used;
+  chunk.used += size;
+  size_ += size;
+  return data;
+}
+
+void ChunkedBuffer::GetBlocks(BlockList& blocks) const {
+  for (size_t i = 0; i < chunks_.size(); ++i) {
+    if (chunks_[i].used > 0)
+      blocks.push_back(std::make_pair(chunks_[i].data, chunks_[i].used));
+  }
+}
+
+CefRefPtr<CefStreamReader> ChunkedBuffer::CreateReader() {
+  BlockList blocks;
+  GetBlocks(blocks);
+  return CreateBlockReader(std::move(blocks), {this});
+}
+
+CefRefPtr<CefStreamReader> CreateBlockReader(
+    BlockList blocks,
+    std::vector<CefRefPtr<CefBaseRefCounted>> owners) {
+  return CefStreamReader::CreateForHandler(
+      new BlockReadHandler(std::move(blocks), std::move(owners)));
+}
+
+CefRefPtr<CefStreamReader> CreateMemoryReader(
+    const void* data,
+    size_t size,
+    CefRefPtr<CefBaseRefCounted> owner) {
+  BlockList blocks;
+  if (size > 0)
+    blocks.push_back(std::make_pair(static_cast<const char*>(data), size));
+  std::vector<CefRefPtr<CefBaseRefCounted>> owners;
+  if (owner)
+    owners.push_back(owner);
+  return CreateBlockReader(std::move(blocks), std::move(owners));
+}
+
+CefRefPtr<CefStreamReader> CreateMemoryReader(std::string data) {
+  return CreateOwnedDataReader(std::move(data));
+}
+
+CefRefPtr<CefStreamReader> CreateMemoryReader(std::vector<char> data) {
+  return CreateOwnedDataReader(std::move(data));
+}
+
+}  // namespace shared
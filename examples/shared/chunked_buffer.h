@@ -0,0 +1,91 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_SHARED_CHUNKED_BUFFER_H_
+#define CEF_EXAMPLES_SHARED_CHUNKED_BUFFER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/cef_stream.h"
+
+namespace shared {
+
+// List of (data, size) memory blocks.
+typedef std::vector<std::pair<const char*, size_t>> BlockList;
+
+// Append-only buffer that stores its contents in a list of fixed-size chunks
+// instead of a single contiguous allocation, so appending never moves or
+// copies existing contents. Chunks are recycled through a process-wide free
+// list when the buffer is destroyed. Not thread-safe; the contents must not
+// be modified after a reader has been created.
+class ChunkedBuffer : public CefBaseRefCounted {
+ public:
+  ChunkedBuffer();
+
+  void Append(const char* data, size_t size);
+  void Append(const std::string& value) { Append(value.data(), value.size()); }
+  void Append(const char* value);
+  void Append(const CefString& value);
+  void Append(size_t value);
+
+  // Returns |size| bytes of contiguous space at the end of the buffer. The
+  // caller must write all |size| bytes.
+  char* Allocate(size_t size);
+
+  // Returns the total size of the contents.
+  size_t size() const { return size_; }
+
+  // Append the blocks that make up the contents to |blocks|.
+  void GetBlocks(BlockList& blocks) const;
+
+  // Returns a reader that streams the contents without copying them.
+  CefRefPtr<CefStreamReader> CreateReader();
+
+ private:
+  struct Chunk {
+    char* data;
+    size_t capacity;
+    size_t used;
+  };
+
+  ~ChunkedBuffer() override;
+
+  // Returns a chunk with at least |size| bytes of capacity.
+  static Chunk NewChunk(size_t size);
+
+  std::vector<Chunk> chunks_;
+  size_t size_;
+
+  IMPLEMENT_REFCOUNTING(ChunkedBuffer);
+  DISALLOW_COPY_AND_ASSIGN(ChunkedBuffer);
+};
+
+// Returns a reader that presents |blocks| as a single seekable stream. Each
+// object in |owners| is kept alive for the lifespan of the reader and should
+// own the memory referenced by |blocks|.
+CefRefPtr<CefStreamReader> CreateBlockReader(
+    BlockList blocks,
+    std::vector<CefRefPtr<CefBaseRefCounted>> owners);
+
+// Returns a reader that presents the |size| bytes at |data| as a seekable
+// stream without copying them. |owner|, if any, is kept alive for the lifespan
+// of the reader and should own the memory. Use nullptr for memory that is
+// never freed, such as the executable's read-only data.
+CefRefPtr<CefStreamReader> CreateMemoryReader(
+    const void* data,
+    size_t size,
+    CefRefPtr<CefBaseRefCounted> owner);
+
+// Returns a reader that takes ownership of |data| and streams it without
+// copying. Use for responses that are generated into a string or vector.
+CefRefPtr<CefStreamReader> CreateMemoryReader(std::string data);
+CefRefPtr<CefStreamReader> CreateMemoryReader(std::vector<char> data);
+
+}  // namespace shared
+
+#endif  // CEF_EXAMPLES_SHARED_CHUNKED_BUFFER_H_
@@ -82,4 +82,9 @@ bool ClientManager::IsClosing() const {
   return is_closing_;
 }
 
+size_t ClientManager::GetBrowserCount() const {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  return browser_list_.size();
+}
+
 }  // namespace shared
@@ -33,6 +33,9 @@ class ClientManager {
   // Returns true if the last browser instance is closing.
   bool IsClosing() const;
 
+  // Returns the number of existing browsers.
+  size_t GetBrowserCount() const;
+
  private:
   base::ThreadChecker thread_checker_;
 
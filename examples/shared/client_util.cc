@@ -4,8 +4,7 @@
 
 #include "examples/shared/client_util.h"
 
-#include <sstream>
-#include <string>
+#include <algorithm>
 
 #include "include/views/cef_browser_view.h"
 #include "include/views/cef_window.h"
@@ -62,20 +61,22 @@ void OnBeforeClose(CefRefPtr<CefBrowser> browser) {
   ClientManager::GetInstance()->OnBeforeClose(browser);
 }
 
-std::string DumpRequestContents(CefRefPtr<CefRequest> request) {
-  std::stringstream ss;
-
-  ss << "URL: " << std::string(request->GetURL());
-  ss << "\nMethod: " << std::string(request->GetMethod());
+void DumpRequestContents(CefRefPtr<CefRequest> request, ChunkedBuffer& out) {
+  out.Append("URL: ");
+  out.Append(request->GetURL());
+  out.Append("\nMethod: ");
+  out.Append(request->GetMethod());
 
   CefRequest::HeaderMap headerMap;
   request->GetHeaderMap(headerMap);
   if (headerMap.size() > 0) {
-    ss << "\nHeaders:";
+    out.Append("\nHeaders:");
     CefRequest::HeaderMap::const_iterator it = headerMap.begin();
     for (; it != headerMap.end(); ++it) {
-      ss << "\n\t" << std::string((*it).first) << ": "
-         << std::string((*it).second);
+      out.Append("\n\t");
+      out.Append(it->first);
+      out.Append(": ");
+      out.Append(it->second);
     }
   }
 
@@ -84,32 +85,40 @@ std::string DumpRequestContents(CefRefPtr<CefRequest> request) {
     CefPostData::ElementVector elements;
     postData->GetElements(elements);
     if (elements.size() > 0) {
-      ss << "\nPost Data:";
-      CefRefPtr<CefPostDataElement> element;
+      out.Append("\nPost Data:");
+
+      // Total number of post data bytes that may still be included.
+      size_t bytes_left = kMaxDumpedPostDataSize;
+
       CefPostData::ElementVector::const_iterator it = elements.begin();
       for (; it != elements.end(); ++it) {
-        element = (*it);
+        CefRefPtr<CefPostDataElement> element = *it;
         if (element->GetType() == PDE_TYPE_BYTES) {
           // the element is composed of bytes
-          ss << "\n\tBytes: ";
-          if (element->GetBytesCount() == 0) {
-            ss << "(empty)";
+          out.Append("\n\tBytes: ");
+          const size_t size = element->GetBytesCount();
+          if (size == 0) {
+            out.Append("(empty)");
           } else {
-            // retrieve the data.
-            size_t size = element->GetBytesCount();
-            char* bytes = new char[size];
-            element->GetBytes(size, bytes);
-            ss << std::string(bytes, size);
-            delete[] bytes;
+            // Retrieve the data directly into the output buffer.
+            const size_t dump_size = std::min(size, bytes_left);
+            if (dump_size > 0) {
+              element->GetBytes(dump_size, out.Allocate(dump_size));
+              bytes_left -= dump_size;
+            }
+            if (dump_size < size) {
+              out.Append("... (");
+              out.Append(size - dump_size);
+              out.Append(" bytes truncated)");
+            }
           }
         } else if (element->GetType() == PDE_TYPE_FILE) {
-          ss << "\n\tFile: " << std::string(element->GetFile());
+          out.Append("\n\tFile: ");
+          out.Append(element->GetFile());
         }
       }
     }
   }
-
-  return ss.str();
 }
 
 }  // namespace shared
@@ -7,6 +7,8 @@
 
 #include "include/cef_client.h"
 
+#include "examples/shared/chunked_buffer.h"
+
 namespace shared {
 
 // This file provides functionality common to all CefClient example
@@ -23,8 +25,13 @@ void OnBeforeClose(CefRefPtr<CefBrowser> browser);
 // Platform-specific implementation.
 void PlatformTitleChange(CefRefPtr<CefBrowser> browser, const CefString& title);
 
-// Returns the contents of |request| as a string.
-std::string DumpRequestContents(CefRefPtr<CefRequest> request);
+// Maximum number of post data bytes included by DumpRequestContents. Any
+// additional bytes are summarized.
+const size_t kMaxDumpedPostDataSize = 64 * 1024;
+
+// Write the contents of |request| to |out|. Post data is copied directly from
+// |request| into |out| and truncated to kMaxDumpedPostDataSize bytes.
+void DumpRequestContents(CefRefPtr<CefRequest> request, ChunkedBuffer& out);
 
 }  // namespace shared
 
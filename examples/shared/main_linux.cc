@@ -6,11 +6,15 @@
 
 #include <X11/Xlib.h>
 
+#include <memory>
+
 #include "include/base/cef_logging.h"
 
 #include "examples/shared/app_factory.h"
 #include "examples/shared/client_manager.h"
 #include "examples/shared/main_util.h"
+#include "examples/shared/resource_dir_index.h"
+#include "examples/shared/worker_pool.h"
 
 namespace shared {
 
@@ -72,6 +76,9 @@ int main(int argc, char* argv[]) {
   // Create the singleton manager instance.
   ClientManager manager;
 
+  // Index the resource directory, if any, before the first request arrives.
+  ResourceDirIndex::Initialize();
+
   // Specify CEF global settings here.
   CefSettings settings;
 
@@ -80,10 +87,21 @@ int main(int argc, char* argv[]) {
   // been initialized.
   CefInitialize(main_args, settings, app, nullptr);
 
+  // Create the worker pool instance. Worker threads can only be created after
+  // CEF has been initialized and must be stopped before CEF is shut down.
+  std::unique_ptr<WorkerPool> worker_pool(new WorkerPool());
+
+  // Watch the resource directory for changes. The watch thread must also be
+  // stopped before CEF is shut down.
+  ResourceDirIndex::StartWatching();
+
   // Run the CEF message loop. This will block until CefQuitMessageLoop() is
   // called.
   CefRunMessageLoop();
 
+  ResourceDirIndex::StopWatching();
+  worker_pool.reset();
+
   // Shut down CEF.
   CefShutdown();
 
@@ -7,12 +7,15 @@
 
 #import <Cocoa/Cocoa.h>
 
+#include <memory>
+
 #include "include/cef_application_mac.h"
 #include "include/wrapper/cef_helpers.h"
 #import "include/wrapper/cef_library_loader.h"
 
 #include "examples/shared/app_factory.h"
 #include "examples/shared/client_manager.h"
+#include "examples/shared/worker_pool.h"
 
 // Receives notifications from the application.
 @interface SharedAppDelegate : NSObject <NSApplicationDelegate>
@@ -151,10 +154,16 @@ int main(int argc, char* argv[]) {
                              withObject:nil
                           waitUntilDone:NO];
 
+  // Create the worker pool instance. Worker threads can only be created after
+  // CEF has been initialized and must be stopped before CEF is shut down.
+  std::unique_ptr<WorkerPool> worker_pool(new WorkerPool());
+
   // Run the CEF message loop. This will block until CefQuitMessageLoop() is
   // called.
   CefRunMessageLoop();
 
+  worker_pool.reset();
+
   // Shut down CEF.
   CefShutdown();
 
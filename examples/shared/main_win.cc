@@ -6,11 +6,14 @@
 
 #include <windows.h>
 
+#include <memory>
+
 #include "include/cef_sandbox_win.h"
 
 #include "examples/shared/app_factory.h"
 #include "examples/shared/client_manager.h"
 #include "examples/shared/main_util.h"
+#include "examples/shared/worker_pool.h"
 
 // When generating projects with CMake the CEF_USE_SANDBOX value will be defined
 // automatically if using the required compiler version. Pass -DUSE_SANDBOX=OFF
@@ -73,10 +76,16 @@ int APIENTRY wWinMain(HINSTANCE hInstance) {
   // been initialized.
   CefInitialize(main_args, settings, app, sandbox_info);
 
+  // Create the worker pool instance. Worker threads can only be created after
+  // CEF has been initialized and must be stopped before CEF is shut down.
+  std::unique_ptr<WorkerPool> worker_pool(new WorkerPool());
+
   // Run the CEF message loop. This will block until CefQuitMessageLoop() is
   // called.
   CefRunMessageLoop();
 
+  worker_pool.reset();
+
   // Shut down CEF.
   CefShutdown();
 
@@ -0,0 +1,150 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_SHARED_RESOURCE_DIR_INDEX_H_
+#define CEF_EXAMPLES_SHARED_RESOURCE_DIR_INDEX_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_lock.h"
+#include "include/cef_stream.h"
+#include "include/cef_thread.h"
+
+#include "examples/shared/resource_util.h"
+
+namespace shared {
+
+// In-memory index of the files in the resource directory on Linux. The
+// directory is scanned once at startup and then kept current with inotify on
+// a dedicated thread, so lookups never touch the filesystem and edits are
+// picked up without restarting the application. Files in the directory take
+// precedence over the resources linked into the executable. Methods may be
+// called on any thread unless otherwise indicated.
+class ResourceDirIndex {
+ public:
+  // Snapshot of a single file. Replaced with a new object when the file
+  // changes.
+  class File : public CefBaseRefCounted {
+   public:
+    File(const std::string& resource_path,
+         const std::string& file_path,
+         time_t mtime,
+         std::string contents,
+         size_t size,
+         bool preloaded);
+
+    // Index entry describing this version of the file. Only valid while a
+    // reference to this object is held.
+    const ResourceEntry* entry() const { return &entry_; }
+
+    const std::string& file_path() const { return file_path_; }
+    time_t mtime() const { return mtime_; }
+
+    // True if |contents()| holds the complete file. Otherwise the file is
+    // larger than kMaxPreloadSize and will be read from disk on demand.
+    bool preloaded() const { return preloaded_; }
+    const std::string& contents() const { return contents_; }
+
+    // Returns a reader for the file contents.
+    CefRefPtr<CefStreamReader> CreateReader();
+
+   private:
+    const std::string path_;
+    const std::string file_path_;
+    const time_t mtime_;
+    const std::string contents_;
+    const bool preloaded_;
+    const std::string mime_type_;
+    const std::string etag_;
+    ResourceEntry entry_;
+
+    IMPLEMENT_REFCOUNTING(File);
+    DISALLOW_COPY_AND_ASSIGN(File);
+  };
+
+  // Called on the watch thread with the resource path of each file that was
+  // added, changed or removed.
+  typedef base::RepeatingCallback<void(const std::string&)> ChangeCallback;
+
+  // Files larger than this are indexed but not preloaded.
+  static const size_t kMaxPreloadSize = 4 * 1024 * 1024;
+
+  // Scan the directory returned by GetResourceDir(), if it exists. Call once
+  // on the main thread of the browser process before CefInitialize so that
+  // the index is complete before the first request.
+  static void Initialize();
+
+  // Start watching the directory for changes. Call on the main thread after
+  // CefInitialize.
+  static void StartWatching();
+
+  // Stop watching the directory. Call on the main thread before CefShutdown.
+  // The index remains usable but is no longer updated.
+  static void StopWatching();
+
+  // Returns the index created by Initialize(), or nullptr if the directory
+  // does not exist or this is not the browser process.
+  static ResourceDirIndex* Get();
+
+  // Returns the current snapshot of |resource_path|, or nullptr if the file
+  // does not exist in the resource directory.
+  CefRefPtr<File> Find(const std::string& resource_path);
+
+  // Set the callback that is notified of changes. Replaces any existing
+  // callback.
+  void SetChangeCallback(const ChangeCallback& callback);
+
+ private:
+  explicit ResourceDirIndex(const std::string& dir);
+
+  // Add the contents of |dir_path| to the index and watch it for changes. The
+  // resource path of each file found is added to |found| if it is not
+  // nullptr.
+  void AddDirectory(const std::string& resource_prefix,
+                    std::set<std::string>* found);
+
+  // Rescan the whole directory after inotify events were lost. Files that no
+  // longer exist are removed.
+  void Rescan();
+
+  // Read |resource_path| from disk and add or replace its snapshot.
+  void UpdateFile(const std::string& resource_path);
+
+  // Remove |resource_path| and, if it was a directory, all files below it.
+  void RemovePath(const std::string& resource_path);
+
+  // Run |change_callback_| for |resource_path|.
+  void NotifyChanged(const std::string& resource_path);
+
+  // Read and apply the pending inotify events, then post the next poll. Runs
+  // on |watch_thread_|.
+  void PollEvents();
+
+  const std::string dir_;
+  int inotify_fd_;
+
+  base::Lock lock_;
+
+  typedef std::map<std::string, CefRefPtr<File>> FileMap;
+  FileMap files_;
+  ChangeCallback change_callback_;
+
+  // Map of inotify watch descriptor to resource path prefix ("" or "dir/").
+  // Only accessed on the watch thread after Initialize().
+  std::map<int, std::string> watches_;
+
+  CefRefPtr<CefThread> watch_thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceDirIndex);
+};
+
+}  // namespace shared
+
+#endif  // CEF_EXAMPLES_SHARED_RESOURCE_DIR_INDEX_H_
@@ -0,0 +1,349 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/shared/resource_dir_index.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "include/base/cef_logging.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+
+#include "examples/shared/chunked_buffer.h"
+
+namespace shared {
+
+namespace {
+
+// Events that change the set of files or their contents.
+const uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                            IN_CREATE | IN_DELETE | IN_ONLYDIR;
+
+// Interval between checks for inotify events.
+const int64_t kPollIntervalMs = 250;
+
+// Index created by Initialize(). Intentionally leaked so that lookups remain
+// valid during shutdown.
+ResourceDirIndex* g_index = nullptr;
+
+// Returns a strong ETag value for |contents|, or a value derived from |size|
+// and |mtime| if the contents are not available.
+std::string MakeETag(const std::string& contents,
+                     bool preloaded,
+                     size_t size,
+                     time_t mtime) {
+  // 64-bit FNV-1a.
+  uint64_t hash = 14695981039346656037ull;
+  if (preloaded) {
+    for (size_t i = 0; i < contents.size(); ++i) {
+      hash ^= static_cast<unsigned char>(contents[i]);
+      hash *= 1099511628211ull;
+    }
+  } else {
+    hash ^= static_cast<uint64_t>(size) * 31 + static_cast<uint64_t>(mtime);
+    hash *= 1099511628211ull;
+  }
+
+  char buff[40];
+  snprintf(buff, sizeof(buff), "\"%s%016llx\"", preloaded ? "d" : "m",
+           static_cast<unsigned long long>(hash));
+  return buff;
+}
+
+// Returns true if the directory entry |name| should be ignored.
+bool IsHidden(const char* name) {
+  return name[0] == '.';
+}
+
+}  // namespace
+
+ResourceDirIndex::File::File(const std::string& resource_path,
+                             const std::string& file_path,
+                             time_t mtime,
+                             std::string contents,
+                             size_t size,
+                             bool preloaded)
+    : path_(resource_path),
+      file_path_(file_path),
+      mtime_(mtime),
+      contents_(std::move(contents)),
+      preloaded_(preloaded),
+      mime_type_(GetMimeType(resource_path)),
+      etag_(MakeETag(contents_, preloaded_, size, mtime_)) {
+  entry_ = {path_.c_str(),
+            path_.length(),
+            nullptr,
+            size,
+            nullptr,
+            0,
+            mime_type_.c_str(),
+            etag_.c_str(),
+            0};
+}
+
+CefRefPtr<CefStreamReader> ResourceDirIndex::File::CreateReader() {
+  if (!preloaded_)
+    return CefStreamReader::CreateForFile(file_path_);
+
+  // Read from memory. The reader keeps this object alive.
+  return CreateMemoryReader(contents_.data(), contents_.size(), this);
+}
+
+// static
+void ResourceDirIndex::Initialize() {
+  DCHECK(!g_index);
+  std::string dir;
+  struct stat st;
+  if (!GetResourceDir(dir) || stat(dir.c_str(), &st) != 0 ||
+      !S_ISDIR(st.st_mode)) {
+    return;
+  }
+  g_index = new ResourceDirIndex(dir);
+}
+
+// static
+void ResourceDirIndex::StartWatching() {
+  if (!g_index || g_index->inotify_fd_ < 0)
+    return;
+  DCHECK(!g_index->watch_thread_);
+  g_index->watch_thread_ = CefThread::CreateThread("ResourceDirWatcher");
+  g_index->watch_thread_->GetTaskRunner()->PostTask(
+      CefCreateClosureTask(base::BindOnce(&ResourceDirIndex::PollEvents,
+                                          base::Unretained(g_index))));
+}
+
+// static
+void ResourceDirIndex::StopWatching() {
+  if (!g_index || !g_index->watch_thread_)
+    return;
+  // Pending polls are discarded.
+  g_index->watch_thread_->Stop();
+  g_index->watch_thread_ = nullptr;
+}
+
+// static
+ResourceDirIndex* ResourceDirIndex::Get() {
+  return g_index;
+}
+
+ResourceDirIndex::ResourceDirIndex(const std::string& dir)
+    : dir_(dir), inotify_fd_(inotify_init1(IN_CLOEXEC | IN_NONBLOCK)) {
+  if (inotify_fd_ < 0)
+    PLOG(WARNING) << "inotify_init1 failed; resource edits will be ignored";
+
+  // Watches are added before each directory is listed so that no changes are
+  // missed.
+  AddDirectory(std::string(), nullptr);
+}
+
+CefRefPtr<ResourceDirIndex::File> ResourceDirIndex::Find(
+    const std::string& resource_path) {
+  base::AutoLock lock_scope(lock_);
+  FileMap::const_iterator it = files_.find(resource_path);
+  if (it != files_.end())
+    return it->second;
+  return nullptr;
+}
+
+void ResourceDirIndex::SetChangeCallback(const ChangeCallback& callback) {
+  base::AutoLock lock_scope(lock_);
+  change_callback_ = callback;
+}
+
+void ResourceDirIndex::AddDirectory(const std::string& resource_prefix,
+                                    std::set<std::string>* found) {
+  const std::string& dir_path = dir_ + "/" + resource_prefix;
+
+  if (inotify_fd_ >= 0) {
+    const int wd = inotify_add_watch(inotify_fd_, dir_path.c_str(), kWatchMask);
+    if (wd >= 0)
+      watches_[wd] = resource_prefix;
+  }
+
+  DIR* dir = opendir(dir_path.c_str());
+  if (!dir)
+    return;
+
+  while (struct dirent* ent = readdir(dir)) {
+    if (IsHidden(ent->d_name))
+      continue;
+
+    const std::string& resource_path = resource_prefix + ent->d_name;
+    unsigned char type = ent->d_type;
+    if (type == DT_UNKNOWN || type == DT_LNK) {
+      // Resolve the type, following symlinks.
+      struct stat st;
+      if (stat((dir_ + "/" + resource_path).c_str(), &st) != 0)
+        continue;
+      type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : 0;
+    }
+
+    if (type == DT_DIR) {
+      AddDirectory(resource_path + "/", found);
+    } else if (type == DT_REG) {
+      UpdateFile(resource_path);
+      if (found)
+        found->insert(resource_path);
+    }
+  }
+  closedir(dir);
+}
+
+void ResourceDirIndex::Rescan() {
+  std::set<std::string> found;
+  AddDirectory(std::string(), &found);
+
+  // Remove the files that were deleted while events were lost.
+  std::vector<std::string> removed;
+  {
+    base::AutoLock lock_scope(lock_);
+    FileMap::iterator it = files_.begin();
+    while (it != files_.end()) {
+      if (found.find(it->first) == found.end()) {
+        removed.push_back(it->first);
+        it = files_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (size_t i = 0; i < removed.size(); ++i)
+    NotifyChanged(removed[i]);
+}
+
+void ResourceDirIndex::UpdateFile(const std::string& resource_path) {
+  const std::string& file_path = dir_ + "/" + resource_path;
+
+  int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    if (fd >= 0)
+      close(fd);
+    RemovePath(resource_path);
+    return;
+  }
+
+  const size_t size = static_cast<size_t>(st.st_size);
+  const bool preload = size <= kMaxPreloadSize;
+  std::string contents;
+  if (preload) {
+    contents.resize(size);
+    size_t offset = 0;
+    while (offset < size) {
+      const ssize_t result = read(fd, &contents[offset], size - offset);
+      if (result <= 0)
+        break;
+      offset += static_cast<size_t>(result);
+    }
+    // The file may have been truncated while reading.
+    contents.resize(offset);
+  }
+  close(fd);
+
+  const size_t indexed_size = preload ? contents.size() : size;
+  CefRefPtr<File> file = new File(resource_path, file_path, st.st_mtime,
+                                  std::move(contents), indexed_size, preload);
+
+  {
+    base::AutoLock lock_scope(lock_);
+    files_[resource_path] = file;
+  }
+  NotifyChanged(resource_path);
+}
+
+void ResourceDirIndex::RemovePath(const std::string& resource_path) {
+  const std::string& prefix = resource_path + "/";
+
+  std::vector<std::string> removed;
+  {
+    base::AutoLock lock_scope(lock_);
+    if (files_.erase(resource_path))
+      removed.push_back(resource_path);
+
+    // Remove any files below a directory with the same path.
+    FileMap::iterator it = files_.lower_bound(prefix);
+    while (it != files_.end() &&
+           it->first.compare(0, prefix.length(), prefix) == 0) {
+      removed.push_back(it->first);
+      it = files_.erase(it);
+    }
+  }
+  for (size_t i = 0; i < removed.size(); ++i)
+    NotifyChanged(removed[i]);
+}
+
+void ResourceDirIndex::NotifyChanged(const std::string& resource_path) {
+  ChangeCallback callback;
+  {
+    base::AutoLock lock_scope(lock_);
+    callback = change_callback_;
+  }
+  if (callback)
+    callback.Run(resource_path);
+}
+
+void ResourceDirIndex::PollEvents() {
+  alignas(struct inotify_event) char buff[64 * 1024];
+
+  while (true) {
+    const ssize_t length = read(inotify_fd_, buff, sizeof(buff));
+    if (length <= 0) {
+      if (length < 0 && errno == EINTR)
+        continue;
+      if (length < 0 && errno != EAGAIN) {
+        PLOG(WARNING) << "inotify read failed; resource edits will be ignored";
+        return;
+      }
+      break;
+    }
+
+    for (ssize_t offset = 0; offset < length;) {
+      const struct inotify_event* event =
+          reinterpret_cast<const struct inotify_event*>(buff + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        // Events were lost. Rescan everything.
+        Rescan();
+        continue;
+      }
+
+      std::map<int, std::string>::iterator it = watches_.find(event->wd);
+      if (it == watches_.end())
+        continue;
+      if (event->mask & IN_IGNORED) {
+        // The directory was removed.
+        watches_.erase(it);
+        continue;
+      }
+      if (event->len == 0 || IsHidden(event->name))
+        continue;
+
+      const std::string& resource_path = it->second + event->name;
+      if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        RemovePath(resource_path);
+      } else if (event->mask & IN_ISDIR) {
+        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+          AddDirectory(resource_path + "/", nullptr);
+      } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+        UpdateFile(resource_path);
+      }
+    }
+  }
+
+  CefTaskRunner::GetForCurrentThread()->PostDelayedTask(
+      CefCreateClosureTask(base::BindOnce(&ResourceDirIndex::PollEvents,
+                                          base::Unretained(this))),
+      kPollIntervalMs);
+}
+
+}  // namespace shared
@@ -0,0 +1,172 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/shared/resource_template.h"
+
+#include <string.h>
+
+#include "include/base/cef_lock.h"
+
+#include "examples/shared/resource_util.h"
+
+namespace shared {
+
+namespace {
+
+// Returns true if |size| bytes at |data| form a valid placeholder name.
+bool IsPlaceholderName(const char* data, size_t size) {
+  if (size == 0)
+    return false;
+  for (size_t i = 0; i < size; ++i) {
+    const char c = data[i];
+    if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'))
+      return false;
+  }
+  return true;
+}
+
+// Cache of parsed templates keyed by resource path. Each template is stored
+// with the object that owned the resource index entry it was parsed from (see
+// GetResourceEntry), which is nullptr for resources linked into the
+// executable. A template is parsed again when a file in the resource directory
+// is replaced with a new snapshot. Methods may be called on any thread.
+class ResourceTemplateCache {
+ public:
+  ResourceTemplateCache() {}
+
+  // Returns the cached template for |resource_path| if it was parsed from
+  // |source|.
+  CefRefPtr<ResourceTemplate> Find(const std::string& resource_path,
+                                   CefRefPtr<CefBaseRefCounted> source) {
+    base::AutoLock lock_scope(lock_);
+    TemplateMap::const_iterator it = templates_.find(resource_path);
+    if (it != templates_.end() && it->second.source == source)
+      return it->second.value;
+    return nullptr;
+  }
+
+  // Returns the cached template for |resource_path| if another thread inserted
+  // one for the same |source| first, otherwise |value|.
+  CefRefPtr<ResourceTemplate> Insert(const std::string& resource_path,
+                                     CefRefPtr<CefBaseRefCounted> source,
+                                     CefRefPtr<ResourceTemplate> value) {
+    base::AutoLock lock_scope(lock_);
+    Entry& entry = templates_[resource_path];
+    if (!entry.value || entry.source != source) {
+      entry.source = source;
+      entry.value = value;
+    }
+    return entry.value;
+  }
+
+ private:
+  struct Entry {
+    CefRefPtr<CefBaseRefCounted> source;
+    CefRefPtr<ResourceTemplate> value;
+  };
+
+  base::Lock lock_;
+
+  typedef std::map<std::string, Entry> TemplateMap;
+  TemplateMap templates_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceTemplateCache);
+};
+
+ResourceTemplateCache* GetResourceTemplateCache() {
+  // Intentionally leaked so that templates remain valid during shutdown.
+  static ResourceTemplateCache* cache = new ResourceTemplateCache();
+  return cache;
+}
+
+}  // namespace
+
+// static
+CefRefPtr<ResourceTemplate> ResourceTemplate::Get(
+    const std::string& resource_path) {
+  // Identify the current version of the resource.
+  CefRefPtr<CefBaseRefCounted> source;
+  if (!GetResourceEntry(resource_path, source))
+    return nullptr;
+
+  ResourceTemplateCache* cache = GetResourceTemplateCache();
+  CefRefPtr<ResourceTemplate> value = cache->Find(resource_path, source);
+  if (value)
+    return value;
+
+  // Load and parse the template without holding the lock. If the file changes
+  // again before it is read the template is parsed again on next use.
+  std::string contents;
+  if (!GetResourceString(resource_path, contents))
+    return nullptr;
+
+  return cache->Insert(resource_path, source,
+                       new ResourceTemplate(std::move(contents)));
+}
+
+ResourceTemplate::ResourceTemplate(std::string contents)
+    : contents_(std::move(contents)) {
+  const char* data = contents_.data();
+  const size_t size = contents_.size();
+
+  size_t literal_start = 0;
+  size_t pos = 0;
+  while (pos < size) {
+    const char* open =
+        static_cast<const char*>(memchr(data + pos, '$', size - pos));
+    if (!open)
+      break;
+    const size_t open_pos = open - data;
+    const char* close = static_cast<const char*>(
+        memchr(open + 1, '$', size - open_pos - 1));
+    if (!close)
+      break;
+    const size_t close_pos = close - data;
+
+    if (!IsPlaceholderName(open + 1, close_pos - open_pos - 1)) {
+      // Not a placeholder. The closing '$' may start the next one.
+      pos = close_pos;
+      continue;
+    }
+
+    if (open_pos > literal_start) {
+      segments_.push_back(
+          {data + literal_start, open_pos - literal_start, false});
+    }
+    segments_.push_back({open + 1, close_pos - open_pos - 1, true});
+    literal_start = pos = close_pos + 1;
+  }
+
+  if (size > literal_start)
+    segments_.push_back({data + literal_start, size - literal_start, false});
+}
+
+CefRefPtr<CefStreamReader> ResourceTemplate::Render(const ValueMap& values,
+                                                    size_t& size) {
+  BlockList blocks;
+  blocks.reserve(segments_.size());
+  std::vector<CefRefPtr<CefBaseRefCounted>> owners(1, this);
+
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    const Segment& segment = segments_[i];
+    if (segment.is_placeholder) {
+      ValueMap::const_iterator it =
+          values.find(std::string(segment.data, segment.size));
+      if (it != values.end() && it->second) {
+        it->second->GetBlocks(blocks);
+        owners.push_back(it->second.get());
+      }
+    } else {
+      blocks.push_back(std::make_pair(segment.data, segment.size));
+    }
+  }
+
+  size = 0;
+  for (size_t i = 0; i < blocks.size(); ++i)
+    size += blocks[i].second;
+
+  return CreateBlockReader(std::move(blocks), std::move(owners));
+}
+
+}  // namespace shared
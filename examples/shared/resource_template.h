@@ -0,0 +1,59 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_SHARED_RESOURCE_TEMPLATE_H_
+#define CEF_EXAMPLES_SHARED_RESOURCE_TEMPLATE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "include/cef_stream.h"
+
+#include "examples/shared/chunked_buffer.h"
+
+namespace shared {
+
+// Resource file containing "$NAME$" placeholders, where NAME consists of
+// uppercase letters, digits and underscores. The file is parsed once into
+// literal and placeholder segments and the parsed form is shared by all
+// responses. Files in the resource directory on Linux are parsed again after
+// they change. Methods may be called on any thread.
+class ResourceTemplate : public CefBaseRefCounted {
+ public:
+  // Map of placeholder name (without the '$' delimiters) to value.
+  typedef std::map<std::string, CefRefPtr<ChunkedBuffer>> ValueMap;
+
+  // Returns the parsed template for |resource_path|, loading it on first use
+  // or when the resource has changed. Returns nullptr if the resource is not
+  // found.
+  static CefRefPtr<ResourceTemplate> Get(const std::string& resource_path);
+
+  // Returns a reader that streams the template contents with each placeholder
+  // replaced by its value from |values|. The output is read directly from the
+  // template and |values| without being concatenated. Placeholders that have
+  // no value are removed. |size| will be set to the total output size.
+  CefRefPtr<CefStreamReader> Render(const ValueMap& values, size_t& size);
+
+ private:
+  struct Segment {
+    // Literal text, or the placeholder name if |is_placeholder| is true.
+    const char* data;
+    size_t size;
+    bool is_placeholder;
+  };
+
+  explicit ResourceTemplate(std::string contents);
+
+  // Template file contents. |segments_| point into this value.
+  const std::string contents_;
+  std::vector<Segment> segments_;
+
+  IMPLEMENT_REFCOUNTING(ResourceTemplate);
+  DISALLOW_COPY_AND_ASSIGN(ResourceTemplate);
+};
+
+}  // namespace shared
+
+#endif  // CEF_EXAMPLES_SHARED_RESOURCE_TEMPLATE_H_
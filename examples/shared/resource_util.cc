@@ -4,54 +4,465 @@
 
 #include "examples/shared/resource_util.h"
 
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+
 #include "include/cef_parser.h"
+#include "include/wrapper/cef_helpers.h"
 #include "include/wrapper/cef_stream_resource_handler.h"
 
+#include "examples/shared/chunked_buffer.h"
+
+#if defined(OS_LINUX)
+#include "examples/shared/resource_dir_index.h"
+#endif
+
 namespace shared {
 
 const char kTestOrigin[] = "https://example.com/";
+const char kResourceCacheControl[] = "max-age=31536000, immutable";
+const char kResourceDirCacheControl[] = "no-cache";
 
 namespace {
 
-// Returns |url| without the query or fragment components, if any.
-std::string GetUrlWithoutQueryOrFragment(const std::string& url) {
-  // Find the first instance of '?' or '#'.
-  const size_t pos = std::min(url.find('?'), url.find('#'));
-  if (pos != std::string::npos)
-    return url.substr(0, pos);
+// Mime type for resource paths without a file extension.
+const char kNoExtensionMimeType[] = "text/html";
+
+// Mime type for unknown or invalid file extensions.
+const char kDefaultMimeType[] = "application/octet-stream";
+
+// Longer extensions are not resolved.
+const size_t kMaxExtensionLength = 16;
+
+struct MimeTypeMapping {
+  const char* extension;
+  const char* mime_type;
+};
+
+// Mime types for common file extensions. Should be kept in sync with
+// MIME_TYPES in tools/make_resource_pack.py.
+constexpr MimeTypeMapping kCommonMimeTypes[] = {
+    {"css", "text/css"},
+    {"gif", "image/gif"},
+    {"htm", "text/html"},
+    {"html", "text/html"},
+    {"ico", "image/x-icon"},
+    {"jpeg", "image/jpeg"},
+    {"jpg", "image/jpeg"},
+    {"js", "text/javascript"},
+    {"json", "application/json"},
+    {"mjs", "text/javascript"},
+    {"mp3", "audio/mpeg"},
+    {"mp4", "video/mp4"},
+    {"ogg", "audio/ogg"},
+    {"pdf", "application/pdf"},
+    {"png", "image/png"},
+    {"svg", "image/svg+xml"},
+    {"txt", "text/plain"},
+    {"wasm", "application/wasm"},
+    {"webm", "video/webm"},
+    {"webp", "image/webp"},
+    {"woff", "font/woff"},
+    {"woff2", "font/woff2"},
+    {"xml", "text/xml"},
+};
+
+// Returns the mime type for a lowercase |extension| from kCommonMimeTypes, or
+// nullptr if the extension is not listed.
+const char* FindCommonMimeType(const char* extension, size_t length) {
+  for (const MimeTypeMapping& mapping : kCommonMimeTypes) {
+    if (strncmp(mapping.extension, extension, length) == 0 &&
+        mapping.extension[length] == '\0') {
+      return mapping.mime_type;
+    }
+  }
+  return nullptr;
+}
+
+// Memoized result of resolving an extension with CefGetMimeType.
+struct MimeTypeMemo {
+  uint32_t hash;
+  std::string extension;
+  std::string mime_type;
+};
+
+// Open addressing table of memoized results. Entries are inserted with
+// compare-and-swap and never removed or modified, so lookups don't lock.
+// Entries are intentionally leaked. Must be a power of 2.
+const size_t kMimeTypeMemoSize = 128;
+
+// Maximum number of slots probed for a single extension.
+const size_t kMimeTypeMemoProbes = 8;
+
+std::atomic<MimeTypeMemo*> g_mime_type_memo[kMimeTypeMemoSize];
+
+const MimeTypeMemo* FindMimeTypeMemo(uint32_t hash,
+                                     const char* extension,
+                                     size_t length) {
+  for (size_t i = 0; i < kMimeTypeMemoProbes; ++i) {
+    const MimeTypeMemo* memo =
+        g_mime_type_memo[(hash + i) & (kMimeTypeMemoSize - 1)].load(
+            std::memory_order_acquire);
+    if (!memo)
+      return nullptr;
+    if (memo->hash == hash && memo->extension.compare(0, std::string::npos,
+                                                      extension, length) == 0) {
+      return memo;
+    }
+  }
+  return nullptr;
+}
+
+void AddMimeTypeMemo(uint32_t hash,
+                     const std::string& extension,
+                     const std::string& mime_type) {
+  MimeTypeMemo* memo = new MimeTypeMemo{hash, extension, mime_type};
+  for (size_t i = 0; i < kMimeTypeMemoProbes; ++i) {
+    MimeTypeMemo* expected = nullptr;
+    std::atomic<MimeTypeMemo*>& slot =
+        g_mime_type_memo[(hash + i) & (kMimeTypeMemoSize - 1)];
+    if (slot.compare_exchange_strong(expected, memo,
+                                     std::memory_order_acq_rel)) {
+      return;
+    }
+    if (expected->hash == hash && expected->extension == extension) {
+      // Another thread added the same extension first.
+      break;
+    }
+  }
+
+  // Already present or no free slot. The result is not memoized.
+  delete memo;
+}
+
+// Returns the "Cache-Control" header value for an entry returned by
+// GetResourceEntry() with |holder|.
+const char* GetCacheControl(CefRefPtr<CefBaseRefCounted> holder) {
+  return holder ? kResourceDirCacheControl : kResourceCacheControl;
+}
+
+// Returns |value| without leading and trailing spaces and tabs.
+std::string TrimWhitespace(const std::string& value) {
+  const size_t start = value.find_first_not_of(" \t");
+  if (start == std::string::npos)
+    return std::string();
+  const size_t end = value.find_last_not_of(" \t");
+  return value.substr(start, end - start + 1);
+}
+
+// Populate |response| for |entry|. Serves the precompressed variant if one
+// exists and |request| accepts it. Creates an empty 304 response if |request|
+// already has the current version. Returns false on failure.
+bool CreateResourceResponse(const std::string& resource_path,
+                            const ResourceEntry& entry,
+                            const std::string& mime_type,
+                            const char* cache_control,
+                            CefRefPtr<CefRequest> request,
+                            ResourceResponse& response) {
+  const bool gzip =
+      entry.gzip_data && request && AcceptsEncoding(request, "gzip");
+  const std::string& etag = GetResourceETag(entry, gzip);
+
+  response.mime_type = mime_type;
+  response.header_map.insert(std::make_pair("ETag", etag));
+  response.header_map.insert(std::make_pair("Cache-Control", cache_control));
+  if (entry.gzip_data) {
+    // The response depends on the request headers so caches must key on
+    // "Accept-Encoding".
+    response.header_map.insert(std::make_pair("Vary", "Accept-Encoding"));
+  }
+
+  if (request && MatchesETag(request, etag)) {
+    // The client already has this version. Don't touch the body.
+    response.status = 304;
+    response.status_text = "Not Modified";
+    return true;
+  }
+
+  if (gzip) {
+    // Serve the precompressed bytes from the executable's read-only data.
+    response.header_map.insert(std::make_pair("Content-Encoding", "gzip"));
+    response.reader =
+        CreateMemoryReader(entry.gzip_data, entry.gzip_size, nullptr);
+  } else {
+    response.reader = GetResourceReader(resource_path);
+    if (!response.reader)
+      return false;
+  }
+
+  response.status = 200;
+  response.status_text = "OK";
+  return true;
+}
 
-  return url;
+// Returns a handler for the response created by CreateResourceResponse(), or
+// nullptr on failure.
+CefRefPtr<CefResourceHandler> CreateResourceHandler(
+    const std::string& resource_path,
+    const ResourceEntry& entry,
+    const std::string& mime_type,
+    const char* cache_control,
+    CefRefPtr<CefRequest> request) {
+  ResourceResponse response;
+  if (!CreateResourceResponse(resource_path, entry, mime_type, cache_control,
+                              request, response)) {
+    return nullptr;
+  }
+  return new CefStreamResourceHandler(response.status, response.status_text,
+                                      response.mime_type, response.header_map,
+                                      response.reader);
 }
 
+// Provider implementation for loading resources from the resource index.
+class ResourceProvider : public CefResourceManager::Provider {
+ public:
+  explicit ResourceProvider(const std::string& root_url)
+      : root_url_(root_url) {
+    DCHECK(!root_url.empty());
+  }
+
+  bool OnRequest(scoped_refptr<CefResourceManager::Request> request) override {
+    CEF_REQUIRE_IO_THREAD();
+
+    const std::string& url = request->url();
+    if (url.find(root_url_) != 0L) {
+      // Not handled by this provider.
+      return false;
+    }
+
+    CefRefPtr<CefResourceHandler> handler;
+
+    const std::string& relative_path = url.substr(root_url_.length());
+    CefRefPtr<CefBaseRefCounted> holder;
+    const ResourceEntry* entry = GetResourceEntry(relative_path, holder);
+    if (entry) {
+      handler = CreateResourceHandler(relative_path, *entry,
+                                      request->mime_type_resolver().Run(url),
+                                      GetCacheControl(holder),
+                                      request->request());
+    }
+
+    request->Continue(handler);
+    return true;
+  }
+
+ private:
+  std::string root_url_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceProvider);
+};
+
 }  // namespace
 
 std::string GetResourcePath(const std::string& url) {
-  if (url.find(kTestOrigin) != 0U)
+  return GetResourcePath(url, kTestOrigin);
+}
+
+std::string GetResourcePath(const std::string& url, const std::string& origin) {
+  if (url.compare(0, origin.length(), origin) != 0)
     return std::string();
 
-  const std::string& url_no_query = GetUrlWithoutQueryOrFragment(url);
-  return url_no_query.substr(sizeof(kTestOrigin) - 1);
+  // Remove the query and/or fragment components, if any.
+  const size_t end = url.find_first_of("?#", origin.length());
+  return url.substr(origin.length(), end == std::string::npos
+                                         ? std::string::npos
+                                         : end - origin.length());
+}
+
+const ResourceEntry* GetResourceEntry(const std::string& resource_path) {
+  return LookupResourceEntry(kResourceIndex, resource_path.data(),
+                             resource_path.size());
+}
+
+const ResourceEntry* GetResourceEntry(const std::string& resource_path,
+                                      CefRefPtr<CefBaseRefCounted>& holder) {
+  holder = nullptr;
+
+#if defined(OS_LINUX)
+  // Files in the resource directory take precedence.
+  ResourceDirIndex* dir_index = ResourceDirIndex::Get();
+  if (dir_index) {
+    CefRefPtr<ResourceDirIndex::File> file = dir_index->Find(resource_path);
+    if (file) {
+      holder = file.get();
+      return file->entry();
+    }
+  }
+#endif
+
+  return GetResourceEntry(resource_path);
 }
 
-// Determine the mime type based on the |file_path| file extension.
 std::string GetMimeType(const std::string& resource_path) {
-  std::string mime_type;
-  size_t sep = resource_path.find_last_of(".");
-  if (sep != std::string::npos) {
-    mime_type = CefGetMimeType(resource_path.substr(sep + 1));
-    if (!mime_type.empty())
-      return mime_type;
+  // Only consider a '.' in the last path component.
+  const size_t sep = resource_path.find_last_of("./");
+  if (sep == std::string::npos || resource_path[sep] != '.')
+    return kNoExtensionMimeType;
+
+  const char* extension = resource_path.data() + sep + 1;
+  const size_t extension_length = resource_path.length() - sep - 1;
+  if (extension_length == 0 || extension_length > kMaxExtensionLength)
+    return kDefaultMimeType;
+
+  // Normalize the extension to lowercase.
+  char lower[kMaxExtensionLength];
+  for (size_t i = 0; i < extension_length; ++i) {
+    lower[i] =
+        static_cast<char>(tolower(static_cast<unsigned char>(extension[i])));
   }
-  return "text/html";
+
+  const char* mime_type = FindCommonMimeType(lower, extension_length);
+  if (mime_type)
+    return mime_type;
+
+  const uint32_t hash = HashResourcePath(lower, extension_length, 0);
+  const MimeTypeMemo* memo = FindMimeTypeMemo(hash, lower, extension_length);
+  if (memo)
+    return memo->mime_type;
+
+  // Resolve the extension using Chromium's mime type registry.
+  std::string resolved = CefGetMimeType(std::string(lower, extension_length));
+  if (resolved.empty())
+    resolved = kDefaultMimeType;
+  AddMimeTypeMemo(hash, std::string(lower, extension_length), resolved);
+  return resolved;
+}
+
+std::string GetMimeTypeForUrl(const std::string& url) {
+  // Remove the query and/or fragment components, if any.
+  return GetMimeType(url.substr(0, url.find_first_of("?#")));
+}
+
+CefResourceManager::Provider* CreateResourceProvider(
+    const std::string& root_url) {
+  return new ResourceProvider(root_url);
 }
 
 CefRefPtr<CefResourceHandler> GetResourceHandler(
     const std::string& resource_path) {
-  CefRefPtr<CefStreamReader> reader = GetResourceReader(resource_path);
-  if (!reader)
+  return GetResourceHandler(resource_path, nullptr);
+}
+
+CefRefPtr<CefResourceHandler> GetResourceHandler(
+    const std::string& resource_path,
+    CefRefPtr<CefRequest> request) {
+  CefRefPtr<CefBaseRefCounted> holder;
+  const ResourceEntry* entry = GetResourceEntry(resource_path, holder);
+  if (!entry)
     return nullptr;
 
-  return new CefStreamResourceHandler(GetMimeType(resource_path), reader);
+  // Prefer the mime type resolved at build time.
+  return CreateResourceHandler(
+      resource_path, *entry,
+      entry->mime_type[0] ? entry->mime_type : GetMimeType(resource_path),
+      GetCacheControl(holder), request);
+}
+
+bool GetResourceResponse(const std::string& resource_path,
+                         CefRefPtr<CefRequest> request,
+                         ResourceResponse& response) {
+  CefRefPtr<CefBaseRefCounted> holder;
+  const ResourceEntry* entry = GetResourceEntry(resource_path, holder);
+  if (!entry)
+    return false;
+
+  return CreateResourceResponse(
+      resource_path, *entry,
+      entry->mime_type[0] ? entry->mime_type : GetMimeType(resource_path),
+      GetCacheControl(holder), request, response);
+}
+
+bool AcceptsEncoding(CefRefPtr<CefRequest> request, const char* encoding) {
+  const std::string& header = request->GetHeaderByName("Accept-Encoding");
+  const size_t encoding_length = strlen(encoding);
+
+  // The header is a comma-separated list of "coding[;q=value]" items.
+  size_t pos = 0;
+  while (pos < header.length()) {
+    size_t end = header.find(',', pos);
+    if (end == std::string::npos)
+      end = header.length();
+
+    const std::string& item = header.substr(pos, end - pos);
+    pos = end + 1;
+
+    const size_t start = item.find_first_not_of(' ');
+    if (start == std::string::npos ||
+        item.compare(start, encoding_length, encoding) != 0) {
+      continue;
+    }
+
+    const size_t params = item.find_first_not_of(' ', start + encoding_length);
+    if (params == std::string::npos)
+      return true;
+    if (item[params] != ';')
+      continue;  // Different coding with the same prefix.
+
+    // Parameters are ';'-separated "name=value" pairs. A quality value of
+    // zero means "not acceptable".
+    size_t param = params + 1;
+    while (param < item.length()) {
+      size_t param_end = item.find(';', param);
+      if (param_end == std::string::npos)
+        param_end = item.length();
+
+      const size_t equals = item.find('=', param);
+      if (equals < param_end &&
+          TrimWhitespace(item.substr(param, equals - param)) == "q") {
+        const std::string& value =
+            TrimWhitespace(item.substr(equals + 1, param_end - equals - 1));
+        return atof(value.c_str()) > 0;
+      }
+      param = param_end + 1;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+std::string GetResourceETag(const ResourceEntry& entry, bool gzip) {
+  std::string etag = entry.etag;
+  if (gzip) {
+    // Insert a suffix before the closing quote.
+    etag.insert(etag.length() - 1, "-gzip");
+  }
+  return etag;
+}
+
+bool MatchesETag(CefRefPtr<CefRequest> request, const std::string& etag) {
+  const std::string& header = request->GetHeaderByName("If-None-Match");
+  if (header.empty())
+    return false;
+
+  // The header is "*" or a comma-separated list of entity tags. Use the weak
+  // comparison function as required for "If-None-Match".
+  size_t pos = 0;
+  while (pos < header.length()) {
+    size_t end = header.find(',', pos);
+    if (end == std::string::npos)
+      end = header.length();
+
+    const std::string& item = header.substr(pos, end - pos);
+    pos = end + 1;
+
+    size_t start = item.find_first_not_of(' ');
+    if (start == std::string::npos)
+      continue;
+    if (item.compare(start, 2, "W/") == 0)
+      start += 2;
+    const size_t length = item.find_last_not_of(' ') + 1 - start;
+
+    if ((length == 1 && item[start] == '*') ||
+        item.compare(start, length, etag) == 0) {
+      return true;
+    }
+  }
+
+  return false;
 }
 
 }  // namespace shared
@@ -5,22 +5,24 @@
 #ifndef CEF_EXAMPLES_SHARED_RESOURCE_UTIL_H_
 #define CEF_EXAMPLES_SHARED_RESOURCE_UTIL_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string>
 
 #include "include/cef_resource_handler.h"
+#include "include/cef_response.h"
 #include "include/cef_stream.h"
-
-#if defined(OS_WIN)
 #include "include/wrapper/cef_resource_manager.h"
-#endif
 
 namespace shared {
 
-// This file provides functionality for resource loading. On Linux amd macOS
-// resource files are loaded from a directory on the filesystem
-// ("<target>_files" sub-directory on Linux, app bundle Resources directory on
-// macOS). On Windows resource files are loaded from BINARY resources built into
-// the executable (see GetResourceId comments for details).
+// This file provides functionality for resource loading. On macOS resource
+// files are loaded from the app bundle Resources directory on the filesystem.
+// On Linux resource files are loaded from a resource pack linked into the
+// executable (see ResourceEntry comments for details). On Windows resource
+// files are loaded from BINARY resources built into the executable (see
+// GetResourceId comments for details).
 
 // Origin for loading local test resources.
 extern const char kTestOrigin[];
@@ -34,23 +36,136 @@ bool GetResourceDir(std::string& dir);
 // if it exists. The URL must start with kTestOrigin.
 std::string GetResourcePath(const std::string& url);
 
-// Determine the mime type based on |resource_path|'s file extension.
+// Same as above but the URL must start with |origin|.
+std::string GetResourcePath(const std::string& url, const std::string& origin);
+
+// Determine the mime type based on |resource_path|'s file extension. Common
+// extensions are resolved from a static table and other extensions are
+// resolved by CefGetMimeType once and then memoized. Returns "text/html" if
+// there is no extension or "application/octet-stream" if the extension is
+// unknown. May be called on any thread.
 std::string GetMimeType(const std::string& resource_path);
 
+// Same as above but removes the query and/or fragment component of |url|
+// first. Suitable for use with CefResourceManager::SetMimeTypeResolver.
+std::string GetMimeTypeForUrl(const std::string& url);
+
+// Resource index entry. Entries are generated at build time for individual
+// executable targets by tools/make_resource_pack.py from the */resources files
+// listed in EXAMPLE_RESOURCES_SRCS (see ADD_EXAMPLE_RESOURCE_PACK in
+// examples/CMakeLists.txt).
+struct ResourceEntry {
+  // Path relative to the */resources directory using '/' separators.
+  const char* path;
+  size_t path_length;
+
+  // File contents linked into the executable on Linux. nullptr on other
+  // platforms.
+  const unsigned char* data;
+  size_t size;
+
+  // Gzip-compressed variant of text resources linked into the executable on
+  // all platforms. nullptr if the resource is not compressible.
+  const unsigned char* gzip_data;
+  size_t gzip_size;
+
+  // Mime type based on the file extension, or empty if the extension is not
+  // known at build time.
+  const char* mime_type;
+
+  // Strong ETag value including quotes, derived from the file contents.
+  const char* etag;
+
+  // BINARY id value on Windows. 0 on other platforms.
+  int id;
+};
+
+// Marks an empty slot in ResourceIndex::slots.
+constexpr uint16_t kNoResourceSlot = 0xffff;
+
+// Perfect hash table of ResourceEntry values. A path is hashed with seed 0 to
+// select a bucket and then with the bucket's seed to select a slot, which
+// holds the index of the only entry that can match.
+struct ResourceIndex {
+  const ResourceEntry* entries;
+  size_t entry_count;
+  const uint32_t* bucket_seeds;
+  size_t bucket_mask;
+  const uint16_t* slots;
+  size_t slot_mask;
+};
+
+// Hash function used by ResourceIndex. Must match hash_path() in
+// tools/make_resource_pack.py.
+constexpr uint32_t HashResourcePath(const char* path,
+                                    size_t length,
+                                    uint32_t seed) {
+  // FNV-1a followed by the MurmurHash3 finalizer.
+  uint32_t hash = 2166136261u ^ seed;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(path[i]);
+    hash *= 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+// Returns the entry in |index| matching |path|, or nullptr if there is no
+// match. Does not allocate.
+constexpr const ResourceEntry* LookupResourceEntry(const ResourceIndex& index,
+                                                   const char* path,
+                                                   size_t length) {
+  const uint32_t seed =
+      index.bucket_seeds[HashResourcePath(path, length, 0) & index.bucket_mask];
+  const uint16_t slot =
+      index.slots[HashResourcePath(path, length, seed) & index.slot_mask];
+  if (slot == kNoResourceSlot)
+    return nullptr;
+
+  const ResourceEntry* entry = &index.entries[slot];
+  if (entry->path_length != length)
+    return nullptr;
+  for (size_t i = 0; i < length; ++i) {
+    if (entry->path[i] != path[i])
+      return nullptr;
+  }
+  return entry;
+}
+
+// Generated resource index for the current executable target.
+extern const ResourceIndex kResourceIndex;
+
+// Returns the resource index entry for |resource_path| that is linked into the
+// executable, or nullptr if the resource is not found.
+const ResourceEntry* GetResourceEntry(const std::string& resource_path);
+
+// Same as above but on Linux files in the resource directory take precedence.
+// If the entry comes from the resource directory |holder| is set to the object
+// that owns it, which must be kept alive for as long as the entry is used.
+// Otherwise |holder| is set to nullptr.
+const ResourceEntry* GetResourceEntry(const std::string& resource_path,
+                                      CefRefPtr<CefBaseRefCounted>& holder);
+
 #if defined(OS_WIN)
-// Returns the BINARY id value associated with |resource_path| on Windows.
-// Implemented for individual executable targets as follows:
+// Returns the BINARY id value associated with |resource_path| on Windows, or 0
+// if the resource is not found. Resources are added for individual executable
+// targets as follows:
 // 1. Add the ID value in */resources/win/resource.h
 // 2. Add the ID to file path mapping in */resources/win/resource.rc
-// 2. Add the |resource_path| to ID mapping in */resource_util_win_impl.cc.
+// The |resource_path| to ID mapping is then added to the generated resource
+// index (see ResourceEntry comments for details).
 int GetResourceId(const std::string& resource_path);
+#endif  // defined(OS_WIN)
 
-// Create a new provider for loading BINARY resources on Windows. Only URLs
-// beginning with |root_url| will be handled by this provider. See the
+// Create a new provider for loading resources from the resource index. Only
+// URLs beginning with |root_url| will be handled by this provider. See the
 // "resource_manager" target for example usage.
-CefResourceManager::Provider* CreateBinaryResourceProvider(
+CefResourceManager::Provider* CreateResourceProvider(
     const std::string& root_url);
-#endif  // defined(OS_WIN)
 
 // Retrieve |resource_path| contents as a std::string. Returns false if the
 // resource is not found.
@@ -65,6 +180,53 @@ CefRefPtr<CefStreamReader> GetResourceReader(const std::string& resource_path);
 CefRefPtr<CefResourceHandler> GetResourceHandler(
     const std::string& resource_path);
 
+// Same as above but serves the precompressed variant of the resource with a
+// "Content-Encoding" header if one exists and the "Accept-Encoding" header of
+// |request| allows it.
+CefRefPtr<CefResourceHandler> GetResourceHandler(
+    const std::string& resource_path,
+    CefRefPtr<CefRequest> request);
+
+// Status, headers and body of the response for a resource.
+struct ResourceResponse {
+  int status;
+  std::string status_text;
+  std::string mime_type;
+  CefResponse::HeaderMap header_map;
+
+  // Response body. nullptr for a 304 response.
+  CefRefPtr<CefStreamReader> reader;
+};
+
+// Populate |response| with the response that GetResourceHandler() would
+// return for |resource_path| and |request|. Returns false if the resource is
+// not found.
+bool GetResourceResponse(const std::string& resource_path,
+                         CefRefPtr<CefRequest> request,
+                         ResourceResponse& response);
+
+// Returns true if the "Accept-Encoding" header of |request| includes
+// |encoding| with a non-zero quality value.
+bool AcceptsEncoding(CefRefPtr<CefRequest> request, const char* encoding);
+
+// "Cache-Control" header value for resources in the resource index. Resources
+// are immutable for the lifespan of the executable so they can be cached
+// indefinitely and revalidated using the ETag value.
+extern const char kResourceCacheControl[];
+
+// "Cache-Control" header value for files in the resource directory on Linux.
+// Files may be edited while the application is running so the client must
+// revalidate using the ETag value before every use.
+extern const char kResourceDirCacheControl[];
+
+// Returns the strong ETag value for |entry|. If |gzip| is true the value will
+// identify the gzip-compressed variant.
+std::string GetResourceETag(const ResourceEntry& entry, bool gzip);
+
+// Returns true if the "If-None-Match" header of |request| matches |etag|. The
+// response should then be sent with a 304 status code and no body.
+bool MatchesETag(CefRefPtr<CefRequest> request, const std::string& etag);
+
 }  // namespace shared
 
 #endif  // CEF_EXAMPLES_SHARED_RESOURCE_UTIL_H_
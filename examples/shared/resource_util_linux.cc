@@ -9,22 +9,90 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "examples/shared/chunked_buffer.h"
+#include "examples/shared/resource_dir_index.h"
+
 namespace shared {
 
-bool GetResourceDir(std::string& dir) {
+namespace {
+
+// Returns the "<executable>_files" directory path, or an empty string if the
+// executable path cannot be determined.
+std::string ResolveResourceDir() {
   char buff[1024];
 
   // Retrieve the executable path.
   ssize_t len = readlink("/proc/self/exe", buff, sizeof(buff) - 1);
   if (len == -1)
-    return false;
+    return std::string();
 
   buff[len] = 0;
 
   // Add "_files" to the path.
   strcpy(buff + len, "_files");
-  dir = std::string(buff);
+  return std::string(buff);
+}
+
+// Returns the snapshot of |resource_path| from the resource directory, if any.
+CefRefPtr<ResourceDirIndex::File> FindResourceFile(
+    const std::string& resource_path) {
+  ResourceDirIndex* dir_index = ResourceDirIndex::Get();
+  if (!dir_index)
+    return nullptr;
+  return dir_index->Find(resource_path);
+}
+
+}  // namespace
+
+bool GetResourceDir(std::string& dir) {
+  // The executable path can't change so only resolve it once.
+  static const std::string resource_dir = ResolveResourceDir();
+  if (resource_dir.empty())
+    return false;
+
+  dir = resource_dir;
   return true;
 }
 
+bool GetResourceString(const std::string& resource_path,
+                       std::string& out_data) {
+  CefRefPtr<ResourceDirIndex::File> file = FindResourceFile(resource_path);
+  if (file) {
+    if (file->preloaded()) {
+      out_data = file->contents();
+      return true;
+    }
+
+    CefRefPtr<CefStreamReader> reader = file->CreateReader();
+    if (!reader)
+      return false;
+
+    out_data.resize(file->entry()->size);
+    const size_t read = reader->Read(&out_data[0], 1, out_data.size());
+    out_data.resize(read);
+    return true;
+  }
+
+  const ResourceEntry* resource = GetResourceEntry(resource_path);
+  if (!resource || !resource->data)
+    return false;
+
+  out_data.assign(reinterpret_cast<const char*>(resource->data),
+                  resource->size);
+  return true;
+}
+
+CefRefPtr<CefStreamReader> GetResourceReader(const std::string& resource_path) {
+  CefRefPtr<ResourceDirIndex::File> file = FindResourceFile(resource_path);
+  if (file)
+    return file->CreateReader();
+
+  const ResourceEntry* resource = GetResourceEntry(resource_path);
+  if (!resource || !resource->data)
+    return nullptr;
+
+  // Read directly from the executable's read-only data.
+  return CreateMemoryReader(resource->data, resource->size, nullptr);
+}
+
 }  // namespace shared
@@ -4,51 +4,122 @@
 
 #include "examples/shared/resource_util.h"
 
-#include <stdio.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+
+#include "include/base/cef_lock.h"
+
+#include "examples/shared/chunked_buffer.h"
 
 namespace shared {
 
 namespace {
 
-bool FileExists(const char* path) {
-  FILE* f = fopen(path, "rb");
-  if (f) {
-    fclose(f);
-    return true;
+// Read-only memory mapping of a single resource file. The mapping is shared by
+// reference between the cache and any outstanding stream readers.
+class MappedFile : public CefBaseRefCounted {
+ public:
+  // Map the file at |path|. Returns nullptr if the file does not exist or
+  // cannot be mapped.
+  static CefRefPtr<MappedFile> Create(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      close(fd);
+      return nullptr;
+    }
+
+    void* data = nullptr;
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size > 0) {
+      data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+      }
+    }
+
+    // The mapping remains valid after the descriptor is closed.
+    close(fd);
+    return new MappedFile(data, size);
   }
-  return false;
-}
 
-bool ReadFileToString(const char* path, std::string& data) {
-  // Implementation adapted from base/file_util.cc
-  FILE* file = fopen(path, "rb");
-  if (!file)
-    return false;
+  const unsigned char* data() const {
+    // Empty files are not mapped.
+    static const unsigned char kEmpty[1] = {0};
+    return data_ ? static_cast<const unsigned char*>(data_) : kEmpty;
+  }
+  size_t size() const { return size_; }
 
-  char buf[1 << 16];
-  size_t len;
-  while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
-    data.append(buf, len);
-  fclose(file);
+ private:
+  MappedFile(void* data, size_t size) : data_(data), size_(size) {}
 
-  return true;
-}
+  ~MappedFile() override {
+    if (data_)
+      munmap(data_, size_);
+  }
 
-}  // namespace
+  void* const data_;
+  const size_t size_;
+
+  IMPLEMENT_REFCOUNTING(MappedFile);
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+// Cache of mapped resource files keyed by absolute path. Resource files are
+// treated as immutable for the lifespan of the process so each file is opened
+// and mapped at most once. Methods may be called on any thread.
+class MappedFileCache {
+ public:
+  MappedFileCache() {}
+
+  // Returns the mapping for |path|, creating it if necessary. Returns nullptr
+  // if the file cannot be mapped. Failed lookups are not cached.
+  CefRefPtr<MappedFile> Get(const std::string& path) {
+    {
+      base::AutoLock lock_scope(lock_);
+      FileMap::const_iterator it = files_.find(path);
+      if (it != files_.end())
+        return it->second;
+    }
+
+    // Map the file without holding the lock. If another thread races us the
+    // first mapping to be inserted wins.
+    CefRefPtr<MappedFile> file = MappedFile::Create(path);
+    if (!file)
+      return nullptr;
+
+    base::AutoLock lock_scope(lock_);
+    return files_.insert(std::make_pair(path, file)).first->second;
+  }
 
-bool GetResourceString(const std::string& resource_path,
-                       std::string& out_data) {
-  std::string path;
-  if (!GetResourceDir(path))
-    return false;
+ private:
+  base::Lock lock_;
 
-  path.append("/");
-  path.append(resource_path);
+  typedef std::map<std::string, CefRefPtr<MappedFile>> FileMap;
+  FileMap files_;
 
-  return ReadFileToString(path.c_str(), out_data);
+  DISALLOW_COPY_AND_ASSIGN(MappedFileCache);
+};
+
+MappedFileCache* GetMappedFileCache() {
+  // Intentionally leaked so that mappings remain valid during shutdown.
+  static MappedFileCache* cache = new MappedFileCache();
+  return cache;
 }
 
-CefRefPtr<CefStreamReader> GetResourceReader(const std::string& resource_path) {
+CefRefPtr<MappedFile> GetMappedResource(const std::string& resource_path) {
+  // Avoid filesystem access for paths that are not in the resource index.
+  if (!GetResourceEntry(resource_path))
+    return nullptr;
+
   std::string path;
   if (!GetResourceDir(path))
     return nullptr;
@@ -56,10 +127,28 @@ CefRefPtr<CefStreamReader> GetResourceReader(const std::string& resource_path) {
   path.append("/");
   path.append(resource_path);
 
-  if (!FileExists(path.c_str()))
+  return GetMappedFileCache()->Get(path);
+}
+
+}  // namespace
+
+bool GetResourceString(const std::string& resource_path,
+                       std::string& out_data) {
+  CefRefPtr<MappedFile> file = GetMappedResource(resource_path);
+  if (!file)
+    return false;
+
+  out_data.assign(reinterpret_cast<const char*>(file->data()), file->size());
+  return true;
+}
+
+CefRefPtr<CefStreamReader> GetResourceReader(const std::string& resource_path) {
+  CefRefPtr<MappedFile> file = GetMappedResource(resource_path);
+  if (!file)
     return nullptr;
 
-  return CefStreamReader::CreateForFile(path);
+  // Read directly from the mapping. The handler keeps |file| alive.
+  return CreateMemoryReader(file->data(), file->size(), file.get());
 }
 
 }  // namespace shared
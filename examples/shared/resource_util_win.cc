@@ -5,8 +5,8 @@
 #include "examples/shared/resource_util.h"
 
 #include "include/base/cef_logging.h"
-#include "include/wrapper/cef_byte_read_handler.h"
-#include "include/wrapper/cef_stream_resource_handler.h"
+
+#include "examples/shared/chunked_buffer.h"
 
 namespace shared {
 
@@ -30,51 +30,11 @@ bool LoadBinaryResource(int binaryId, DWORD& dwSize, LPBYTE& pBytes) {
   return false;
 }
 
-// Provider implementation for loading BINARY resources from the current
-// executable.
-class BinaryResourceProvider : public CefResourceManager::Provider {
- public:
-  explicit BinaryResourceProvider(const std::string& root_url)
-      : root_url_(root_url) {
-    DCHECK(!root_url.empty());
-  }
-
-  bool OnRequest(scoped_refptr<CefResourceManager::Request> request) override {
-    CEF_REQUIRE_IO_THREAD();
-
-    const std::string& url = request->url();
-    if (url.find(root_url_) != 0L) {
-      // Not handled by this provider.
-      return false;
-    }
-
-    CefRefPtr<CefResourceHandler> handler;
-
-    const std::string& relative_path = url.substr(root_url_.length());
-    if (!relative_path.empty()) {
-      CefRefPtr<CefStreamReader> stream =
-          GetResourceReader(relative_path.data());
-      if (stream.get()) {
-        handler = new CefStreamResourceHandler(
-            request->mime_type_resolver().Run(url), stream);
-      }
-    }
-
-    request->Continue(handler);
-    return true;
-  }
-
- private:
-  std::string root_url_;
-
-  DISALLOW_COPY_AND_ASSIGN(BinaryResourceProvider);
-};
-
 }  // namespace
 
-CefResourceManager::Provider* CreateBinaryResourceProvider(
-    const std::string& url_path) {
-  return new BinaryResourceProvider(url_path);
+int GetResourceId(const std::string& resource_path) {
+  const ResourceEntry* entry = GetResourceEntry(resource_path);
+  return entry ? entry->id : 0;
 }
 
 bool GetResourceString(const std::string& resource_path,
@@ -104,8 +64,7 @@ CefRefPtr<CefStreamReader> GetResourceReader(const std::string& resource_path) {
   LPBYTE pBytes;
 
   if (LoadBinaryResource(resource_id, dwSize, pBytes)) {
-    return CefStreamReader::CreateForHandler(
-        new CefByteReadHandler(pBytes, dwSize, nullptr));
+    return CreateMemoryReader(pBytes, dwSize, nullptr);
   }
 
   NOTREACHED();  // The resource should be found.
@@ -0,0 +1,88 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#include "examples/shared/worker_pool.h"
+
+#include <sstream>
+
+#include "include/base/cef_lock.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+
+namespace shared {
+
+namespace {
+
+// Number of pool threads. Bounds the number of blocking operations that can be
+// in progress at the same time.
+const size_t kThreadCount = 4;
+
+// Protects |g_pool| and WorkerPool::next_thread_. Intentionally leaked so
+// that PostTask can be safely called during shutdown.
+base::Lock& GetPoolLock() {
+  static base::Lock* lock = new base::Lock();
+  return *lock;
+}
+
+WorkerPool* g_pool = nullptr;
+
+}  // namespace
+
+WorkerPool::WorkerPool() : next_thread_(0) {
+  CEF_REQUIRE_UI_THREAD();
+
+  for (size_t i = 0; i < kThreadCount; ++i) {
+    std::stringstream ss;
+    ss << "ExampleWorker" << i;
+    threads_.push_back(CefThread::CreateThread(ss.str()));
+  }
+
+  base::AutoLock lock_scope(GetPoolLock());
+  DCHECK(!g_pool);
+  g_pool = this;
+}
+
+WorkerPool::~WorkerPool() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  {
+    // Reject new tasks before stopping the threads.
+    base::AutoLock lock_scope(GetPoolLock());
+    g_pool = nullptr;
+  }
+
+  // Blocks until already posted tasks have completed.
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->Stop();
+}
+
+// static
+bool WorkerPool::PostTask(base::OnceClosure task) {
+  base::AutoLock lock_scope(GetPoolLock());
+  if (!g_pool)
+    return false;
+
+  CefRefPtr<CefThread> thread = g_pool->threads_[g_pool->next_thread_];
+  g_pool->next_thread_ = (g_pool->next_thread_ + 1) % g_pool->threads_.size();
+  return thread->GetTaskRunner()->PostTask(
+      CefCreateClosureTask(std::move(task)));
+}
+
+// static
+void WorkerPool::PostBlockingTask(base::OnceClosure task) {
+  {
+    base::AutoLock lock_scope(GetPoolLock());
+    if (g_pool) {
+      CefRefPtr<CefThread> thread = g_pool->threads_[g_pool->next_thread_];
+      g_pool->next_thread_ =
+          (g_pool->next_thread_ + 1) % g_pool->threads_.size();
+      thread->GetTaskRunner()->PostTask(CefCreateClosureTask(std::move(task)));
+      return;
+    }
+  }
+
+  CefPostTask(TID_FILE_USER_BLOCKING, std::move(task));
+}
+
+}  // namespace shared
@@ -0,0 +1,52 @@
+// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+
+#ifndef CEF_EXAMPLES_SHARED_WORKER_POOL_H_
+#define CEF_EXAMPLES_SHARED_WORKER_POOL_H_
+
+#include <vector>
+
+#include "include/base/cef_callback.h"
+#include "include/base/cef_thread_checker.h"
+#include "include/cef_thread.h"
+
+namespace shared {
+
+// Fixed-size pool of threads for running blocking work, such as file I/O,
+// without stalling the browser process UI and IO threads. The constructor and
+// destructor must be called on the main application thread (browser process UI
+// thread) after CefInitialize and before CefShutdown respectively.
+class WorkerPool {
+ public:
+  WorkerPool();
+  ~WorkerPool();
+
+  // Post |task| for execution on one of the pool threads. Tasks are
+  // distributed round-robin and may run concurrently with each other. Returns
+  // false if the pool does not exist or is shutting down, in which case the
+  // caller should run the work itself. May be called on any thread.
+  static bool PostTask(base::OnceClosure task);
+
+  // Post |task| for execution on one of the pool threads, or on the CEF
+  // TID_FILE_USER_BLOCKING thread if the pool does not exist. Use this for
+  // work that is started before the pool is created, such as from
+  // CefBrowserProcessHandler::OnContextInitialized which runs inside
+  // CefInitialize. May be called on any thread after CEF is initialized.
+  static void PostBlockingTask(base::OnceClosure task);
+
+ private:
+  base::ThreadChecker thread_checker_;
+
+  std::vector<CefRefPtr<CefThread>> threads_;
+
+  // Index of the thread that will receive the next task. Protected by the
+  // global pool lock.
+  size_t next_thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+}  // namespace shared
+
+#endif  // CEF_EXAMPLES_SHARED_WORKER_POOL_H_
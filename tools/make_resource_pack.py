@@ -0,0 +1,353 @@
+# Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+# reserved. Use of this source code is governed by a BSD-style license that
+# can be found in the LICENSE file
+
+# Generates a C++ source file containing the resource index for an executable
+# target. The index is a minimal perfect hash table that maps resource paths to
+# shared::ResourceEntry values. Gzip-compressed variants of text resources are
+# always linked into the executable. Optionally the uncompressed resource file
+# contents are also linked into the executable. See shared::ResourceIndex in
+# examples/shared/resource_util.h for the generated table format.
+
+from __future__ import absolute_import
+from __future__ import print_function
+from io import open
+from optparse import OptionParser
+import gzip
+import hashlib
+import io
+import os
+import re
+import sys
+
+# Number of bytes written per line of the generated array.
+BYTES_PER_LINE = 16
+
+# Marks an empty slot in the generated slot table. Must match
+# shared::kNoResourceSlot.
+NO_SLOT = 0xffff
+
+# Mime types that are compressed at build time in addition to "text/*".
+COMPRESSIBLE_MIME_TYPES = [
+    'application/json',
+    'application/wasm',
+    'image/svg+xml',
+]
+
+# Compressed variants are only kept if they are at most this fraction of the
+# uncompressed size.
+MAX_COMPRESSION_RATIO = 0.9
+
+# Maximum number of displacement seeds tried per bucket.
+MAX_SEED = 1 << 20
+
+# Mime types for common resource file extensions. Resources with other
+# extensions are resolved at runtime by shared::GetMimeType. Should be kept in
+# sync with kCommonMimeTypes in examples/shared/resource_util.cc.
+MIME_TYPES = {
+    'css': 'text/css',
+    'gif': 'image/gif',
+    'htm': 'text/html',
+    'html': 'text/html',
+    'ico': 'image/x-icon',
+    'jpeg': 'image/jpeg',
+    'jpg': 'image/jpeg',
+    'js': 'text/javascript',
+    'json': 'application/json',
+    'mjs': 'text/javascript',
+    'mp3': 'audio/mpeg',
+    'mp4': 'video/mp4',
+    'ogg': 'audio/ogg',
+    'pdf': 'application/pdf',
+    'png': 'image/png',
+    'svg': 'image/svg+xml',
+    'txt': 'text/plain',
+    'wasm': 'application/wasm',
+    'webm': 'video/webm',
+    'webp': 'image/webp',
+    'woff': 'font/woff',
+    'woff2': 'font/woff2',
+    'xml': 'text/xml',
+}
+
+
+def read_binary_file(name):
+  """ Read a file as bytes. """
+  with open(name, 'rb') as f:
+    return bytearray(f.read())
+
+
+def read_text_file(name):
+  """ Read a file as text. """
+  with open(name, 'r', encoding='utf-8', errors='replace') as f:
+    return f.read()
+
+
+def write_file(name, data):
+  """ Write a file. """
+  with open(name, 'w', encoding='utf-8') as f:
+    f.write(data)
+
+
+def get_resource_path(root_dir, file_name):
+  """ Returns the resource path for |file_name| relative to |root_dir| using
+      Unix path separators. """
+  path = os.path.relpath(file_name, root_dir)
+  if path.startswith(os.pardir):
+    raise Exception('%s is not inside %s' % (file_name, root_dir))
+  return path.replace('\\', '/')
+
+
+def get_mime_type(path):
+  ext = os.path.splitext(path)[1][1:].lower()
+  return MIME_TYPES.get(ext, '')
+
+
+def get_etag(data):
+  """ Returns a strong ETag value derived from the file contents. """
+  return '"%s"' % hashlib.sha256(data).hexdigest()[:32]
+
+
+def get_gzip_variant(mime_type, data):
+  """ Returns the gzip-compressed variant of |data|, or None if the resource
+      should not be compressed. """
+  if not mime_type.startswith('text/') and \
+     not mime_type in COMPRESSIBLE_MIME_TYPES:
+    return None
+
+  # Use a fixed modification time so that the output is reproducible.
+  buf = io.BytesIO()
+  with gzip.GzipFile(fileobj=buf, mode='wb', compresslevel=9, mtime=0) as f:
+    f.write(data)
+  compressed = bytearray(buf.getvalue())
+  if len(compressed) > len(data) * MAX_COMPRESSION_RATIO:
+    return None
+  return compressed
+
+
+def read_binary_ids(rc_file, rc_header, root_dir):
+  """ Returns a map of resource path to BINARY id value parsed from a Windows
+      resource script and the header that defines its id values. """
+  values = {}
+  for match in re.finditer(r'^#define\s+(\w+)\s+(\d+)\s*$',
+                           read_text_file(rc_header), re.MULTILINE):
+    values[match.group(1)] = int(match.group(2))
+
+  ids = {}
+  rc_dir = os.path.dirname(rc_file)
+  for match in re.finditer(r'^(\w+)\s+BINARY\s+"([^"]+)"',
+                           read_text_file(rc_file), re.MULTILINE):
+    name = match.group(1)
+    if not name in values:
+      raise Exception('%s is not defined in %s' % (name, rc_header))
+    file_name = match.group(2).replace('\\\\', '/').replace('\\', '/')
+    path = get_resource_path(root_dir,
+                             os.path.normpath(os.path.join(rc_dir, file_name)))
+    ids[path] = values[name]
+  return ids
+
+
+def hash_path(path, seed):
+  """ Must match shared::HashResourcePath. """
+  value = (2166136261 ^ seed) & 0xffffffff
+  for b in bytearray(path.encode('utf-8')):
+    value ^= b
+    value = (value * 16777619) & 0xffffffff
+  value ^= value >> 16
+  value = (value * 0x85ebca6b) & 0xffffffff
+  value ^= value >> 13
+  value = (value * 0xc2b2ae35) & 0xffffffff
+  value ^= value >> 16
+  return value
+
+
+def next_power_of_two(value):
+  result = 1
+  while result < value:
+    result <<= 1
+  return result
+
+
+def make_perfect_hash(paths):
+  """ Returns (bucket_seeds, slots) for a perfect hash of |paths| using the
+      hash and displace algorithm. A path is found by hashing with seed 0 to
+      select a bucket, and then hashing with the bucket's seed to select a
+      slot. """
+  bucket_count = next_power_of_two(max(1, len(paths) // 2))
+  slot_count = next_power_of_two(len(paths))
+
+  buckets = [[] for i in range(bucket_count)]
+  for index, path in enumerate(paths):
+    buckets[hash_path(path, 0) & (bucket_count - 1)].append(index)
+
+  bucket_seeds = [0] * bucket_count
+  slots = [NO_SLOT] * slot_count
+
+  # Place the largest buckets first while the most slots are free.
+  order = sorted(
+      range(bucket_count), key=lambda b: len(buckets[b]), reverse=True)
+  for bucket in order:
+    entries = buckets[bucket]
+    if not entries:
+      continue
+    for seed in range(1, MAX_SEED):
+      placed = [hash_path(paths[i], seed) & (slot_count - 1) for i in entries]
+      if len(set(placed)) == len(placed) and \
+         all([slots[s] == NO_SLOT for s in placed]):
+        for i, s in zip(entries, placed):
+          slots[s] = i
+        bucket_seeds[bucket] = seed
+        break
+    else:
+      raise Exception('Failed to find a perfect hash seed')
+
+  return (bucket_seeds, slots)
+
+
+def c_string(value):
+  """ Returns |value| as a quoted C string literal. """
+  return '"%s"' % value.replace('\\', '\\\\').replace('"', '\\"')
+
+
+def format_values(values, per_line, fmt):
+  lines = []
+  for i in range(0, len(values), per_line):
+    chunk = values[i:i + per_line]
+    lines.append('    ' + ' '.join([fmt % v for v in chunk]))
+  if not lines:
+    # Zero-length arrays are not allowed.
+    lines.append('    ' + fmt % 0)
+  return '\n'.join(lines)
+
+
+def make_resource_pack(root_dir, file_names, embed, binary_ids):
+  resources = []
+  for file_name in file_names:
+    resources.append((get_resource_path(root_dir, file_name),
+                      read_binary_file(file_name)))
+  if len(resources) >= NO_SLOT:
+    raise Exception('Too many resource files')
+
+  resources.sort(key=lambda r: r[0])
+  paths = [r[0] for r in resources]
+  (bucket_seeds, slots) = make_perfect_hash(paths)
+
+  blob = bytearray()
+  entries = []
+  checks = []
+  for index, (path, data) in enumerate(resources):
+    if embed:
+      data_ptr = 'kPackData + %d' % len(blob)
+      blob += data
+    else:
+      data_ptr = 'nullptr'
+
+    mime_type = get_mime_type(path)
+    gzip_data = get_gzip_variant(mime_type, data)
+    if gzip_data:
+      gzip_ptr = 'kPackData + %d' % len(blob)
+      gzip_size = len(gzip_data)
+      blob += gzip_data
+    else:
+      gzip_ptr = 'nullptr'
+      gzip_size = 0
+
+    path_length = len(path.encode('utf-8'))
+    entries.append('    {%s, %d, %s, %d, %s, %d, %s, %s, %d},' %
+                   (c_string(path), path_length, data_ptr, len(data),
+                    gzip_ptr, gzip_size, c_string(mime_type),
+                    c_string(get_etag(data)), binary_ids.get(path, 0)))
+    checks.append('static_assert(LookupResourceEntry(kIndex, %s, %d) == '
+                  '&kEntries[%d],\n              "Invalid resource index");' %
+                  (c_string(path), path_length, index))
+
+  entry_lines = entries
+  if not entry_lines:
+    # Zero-length arrays are not allowed. The index of a target without
+    # resources has no slots that refer to this entry.
+    entry_lines = ['    {"", 0, nullptr, 0, nullptr, 0, "", "", 0},']
+
+  pack_data = ''
+  if blob:
+    pack_data = """alignas(16) const unsigned char kPackData[] = {
+%s
+};
+
+""" % format_values(blob, BYTES_PER_LINE, '0x%02x,')
+
+  result = """// Copyright (c) 2026 The Chromium Embedded Framework Authors. All rights
+// reserved. Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+//
+// ---------------------------------------------------------------------------
+//
+// This file was generated by tools/make_resource_pack.py. Do not edit.
+//
+
+#include "examples/shared/resource_util.h"
+
+namespace shared {
+
+namespace {
+
+%sconstexpr ResourceEntry kEntries[] = {
+%s
+};
+
+constexpr uint32_t kBucketSeeds[] = {
+%s
+};
+
+constexpr uint16_t kSlots[] = {
+%s
+};
+
+constexpr ResourceIndex kIndex = {kEntries, %d, kBucketSeeds, %d, kSlots, %d};
+
+// Verify the index at compile time.
+%s
+
+}  // namespace
+
+const ResourceIndex kResourceIndex = kIndex;
+
+}  // namespace shared
+""" % (pack_data, '\n'.join(entry_lines), format_values(bucket_seeds, 8, '%d,'),
+       format_values(slots, 8, '%d,'), len(entries), len(bucket_seeds) - 1,
+       len(slots) - 1, '\n'.join(checks))
+  return result
+
+
+if __name__ == "__main__":
+  parser = OptionParser(usage='%prog [options] [file1 [file2 ...]]')
+  parser.add_option(
+      '--output', dest='output', help='generated C++ source file')
+  parser.add_option(
+      '--root',
+      dest='root',
+      help='resource root directory; resource paths are relative to this')
+  parser.add_option(
+      '--embed',
+      action='store_true',
+      dest='embed',
+      default=False,
+      help='link the resource file contents into the executable')
+  parser.add_option(
+      '--rc', dest='rc', help='Windows resource script with BINARY ids')
+  parser.add_option(
+      '--rc-header',
+      dest='rc_header',
+      help='header defining the Windows resource script id values')
+  (options, args) = parser.parse_args()
+
+  if not options.output or not options.root or \
+     bool(options.rc) != bool(options.rc_header):
+    parser.print_help(sys.stderr)
+    sys.exit(1)
+
+  binary_ids = {}
+  if options.rc:
+    binary_ids = read_binary_ids(options.rc, options.rc_header, options.root)
+
+  write_file(options.output,
+             make_resource_pack(options.root, args, options.embed, binary_ids))